@@ -0,0 +1,25 @@
+#-------------------------------------------------
+#
+# 键盘及配套工具的顶层工程，一次qmake即可构建全部目标
+# 各子工程与本文件在同一目录，生成各自的Makefile.<名称>，工具的中间文件放在各自的目录中
+# 例: qmake all.pro && make
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS = softkeyboard dictc dictdiff
+
+softkeyboard.file = softkeyboard.pro
+softkeyboard.makefile = Makefile.softkeyboard
+dictc.file = dictc.pro
+dictc.makefile = Makefile.dictc
+dictdiff.file = dictdiff.pro
+dictdiff.makefile = Makefile.dictdiff
+
+#渲染基准测试需要Qt5的offscreen平台
+greaterThan(QT_MAJOR_VERSION, 4) {
+    SUBDIRS += renderbench
+    renderbench.file = renderbench.pro
+    renderbench.makefile = Makefile.renderbench
+}
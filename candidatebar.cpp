@@ -0,0 +1,419 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  候选条，自绘的水平候选词列表。候选词按实际文字宽度(缓存)依次排列，一行能放下
+ * 多少就显示多少；候选词按需分批获取，拖动时惯性滚动，重绘只绘制可见范围内的候选词
+ */
+#include "candidatebar.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QFontMetrics>
+#include <qmath.h>
+#include <algorithm>
+
+#define ITEMPADDING         12      //候选词文字两侧的留白(像素)
+#define DRAGTHRESHOLD       8       //移动超过该距离(像素)视为拖动，不再作为点击
+#define FETCHAHEADSCREENS   2       //保证已获取的候选词至少排到可见范围之后的屏数
+#define KINETICINTERVAL     16      //惯性滚动的刷新间隔(ms)
+#define KINETICFRICTION     0.95    //惯性滚动每次刷新的速度衰减
+#define MINKINETICVELOCITY  0.05    //惯性滚动的最小速度(像素/ms)，低于该速度停止
+#define KINETICIDLETIME     100     //松开前停顿超过该时间(ms)则不惯性滚动
+#define MAXWIDTHCACHESIZE   4096    //文字宽度缓存的最大条数
+
+/*
+ *@brief:   按候选词左边界查找的比较函数
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+template<typename Item>
+static bool lessItemLeft(int x,const Item &item)
+{
+    return x < item.left;
+}
+
+/*
+ *@brief:   候选条构造函数
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   cache:文字图片缓存，候选词文字直接贴图，为空时直接绘制文字
+ *@param:   parent:父对象
+ */
+CandidateBar::CandidateBar(TextPixmapCache *cache, QWidget *parent) :
+    QWidget(parent),textCache(cache),hasMoreCandidates(false),isFetching(false),scrollOffset(0),
+    pressedIndex(-1),pressX(0),pressOffset(0),isDragging(false),lastMoveX(0),velocity(0)
+{
+    //背景由paintEvent完整绘制，滚动时可以直接移动已绘制的内容，只重绘露出的部分
+    this->setAttribute(Qt::WA_OpaquePaintEvent);
+    this->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Preferred);
+    kineticTimer = new QTimer(this);
+    kineticTimer->setInterval(KINETICINTERVAL);
+    connect(kineticTimer,SIGNAL(timeout()),this,SLOT(kineticScrollSlot()));
+}
+/*
+ *@brief:   清空候选词并回到起始位置，文字宽度缓存保留，供后续的候选词使用
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void CandidateBar::clear()
+{
+    kineticTimer->stop();
+    items.clear();
+    hasMoreCandidates = false;
+    scrollOffset = 0;
+    pressedIndex = -1;
+    isDragging = false;
+    update();
+}
+/*
+ *@brief:   追加一批候选词，排在已有候选词之后。只有落在可见范围内的新候选词才触发重绘
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   candidateList:候选词，按显示顺序排列
+ *@param:   hasMore:之后是否还有候选词
+ */
+void CandidateBar::appendCandidates(const QStringList &candidateList, bool hasMore)
+{
+    int left = contentWidth();
+    int firstNewLeft = left-scrollOffset;
+    items.reserve(items.size()+candidateList.size());
+    for(int i=0;i<candidateList.size();i++)
+    {
+        Item item;
+        item.text = candidateList.at(i);
+        item.left = left;
+        item.width = textWidth(item.text)+2*ITEMPADDING;
+        items.append(item);
+        left += item.width;
+    }
+    hasMoreCandidates = hasMore;
+    if(firstNewLeft < width() && !candidateList.isEmpty())
+    {
+        update(QRect(firstNewLeft,0,width()-firstNewLeft,height()));
+    }
+    fetchIfNeeded();
+}
+
+int CandidateBar::count() const
+{
+    return items.size();
+}
+
+QString CandidateBar::candidate(int index) const
+{
+    if(index<0 || index>=items.size())
+    {
+        return QString();
+    }
+    return items.at(index).text;
+}
+
+int CandidateBar::firstVisibleIndex() const
+{
+    int index = itemAt(0);
+    if(index < 0)
+    {
+        return 0;
+    }
+    if(items.at(index).left < scrollOffset && index+1 < items.size())//左侧部分被遮挡
+    {
+        index++;
+    }
+    return index;
+}
+/*
+ *@brief:   绘制候选条。只绘制与重绘区域相交的候选词，由于候选词按位置有序，
+ * 用二分查找定位第一个需要绘制的候选词
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void CandidateBar::paintEvent(QPaintEvent *event)
+{
+    QElapsedTimer paintTimer;
+    paintTimer.start();
+    QPainter painter(this);
+    QRect dirtyRect = event->rect();
+    painter.fillRect(dirtyRect,palette().color(QPalette::Window));
+    int index = itemAt(qMax(0,dirtyRect.left()));//没有候选词时为-1
+    QColor textColor = palette().color(QPalette::WindowText);
+    for(;index>=0 && index<items.size();index++)
+    {
+        QRect rect = itemRect(index);
+        if(rect.left() > dirtyRect.right())
+        {
+            break;
+        }
+        if(index == pressedIndex && !isDragging)//按下的候选词
+        {
+            QColor pressedColor = textColor;
+            pressedColor.setAlpha(48);
+            painter.fillRect(rect,pressedColor);
+        }
+        const QString &text = items.at(index).text;
+        if(textCache)
+        {
+            QPixmap textPixmap = textCache->pixmap(text,font(),textColor);
+            painter.drawPixmap(rect.center()-QPoint(textPixmap.width()/2,textPixmap.height()/2),textPixmap);
+        }
+        else
+        {
+            painter.setPen(textColor);
+            painter.drawText(rect,Qt::AlignCenter,text);
+        }
+    }
+    paintHistogram.add(paintTimer.nsecsElapsed());
+}
+/*
+ *@brief:   获取候选条绘制耗时的分布
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+LatencyHistogram CandidateBar::paintStatistics() const
+{
+    return paintHistogram;
+}
+
+void CandidateBar::resetPaintStatistics()
+{
+    paintHistogram.clear();
+}
+/*
+ *@brief:   鼠标按下，惯性滚动时按下只停止滚动，不作为点击
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void CandidateBar::mousePressEvent(QMouseEvent *event)
+{
+    if(event->button() != Qt::LeftButton)
+    {
+        return;
+    }
+    bool isScrolling = kineticTimer->isActive();
+    kineticTimer->stop();
+    pressX = event->pos().x();
+    lastMoveX = pressX;
+    pressOffset = scrollOffset;
+    isDragging = false;
+    velocity = 0;
+    moveTimer.start();
+    pressedIndex = isScrolling?-1:itemAt(pressX);
+    if(pressedIndex >= 0)
+    {
+        update(itemRect(pressedIndex));
+    }
+}
+/*
+ *@brief:   鼠标移动，超过阈值后拖动内容，并记录速度用于松开后的惯性滚动
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void CandidateBar::mouseMoveEvent(QMouseEvent *event)
+{
+    int x = event->pos().x();
+    if(!isDragging && qAbs(x-pressX) > DRAGTHRESHOLD)
+    {
+        isDragging = true;
+        if(pressedIndex >= 0)
+        {
+            update(itemRect(pressedIndex));
+        }
+    }
+    if(!isDragging)
+    {
+        return;
+    }
+    qint64 elapsed = qMax(Q_INT64_C(1),moveTimer.restart());
+    qreal instantVelocity = qreal(lastMoveX-x)/elapsed;
+    velocity = 0.8*instantVelocity+0.2*velocity;//平滑速度，减少抖动
+    lastMoveX = x;
+    scrollTo(pressOffset+pressX-x);
+}
+/*
+ *@brief:   鼠标松开，未拖动时提交候选词，拖动时按松开前的速度惯性滚动
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void CandidateBar::mouseReleaseEvent(QMouseEvent *event)
+{
+    if(event->button() != Qt::LeftButton)
+    {
+        return;
+    }
+    int releasedIndex = pressedIndex;
+    pressedIndex = -1;
+    if(isDragging)
+    {
+        isDragging = false;
+        if(moveTimer.elapsed() > KINETICIDLETIME)
+        {
+            velocity = 0;
+        }
+        if(qAbs(velocity) > MINKINETICVELOCITY)
+        {
+            kineticTimer->start();
+        }
+        return;
+    }
+    if(releasedIndex >= 0)
+    {
+        update(itemRect(releasedIndex));
+        if(itemAt(event->pos().x()) == releasedIndex)
+        {
+            emit candidateClicked(items.at(releasedIndex).text);
+        }
+    }
+}
+
+void CandidateBar::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    scrollTo(scrollOffset);
+    fetchIfNeeded();
+}
+/*
+ *@brief:   字体改变(如切换皮肤)后文字宽度缓存失效，重新排列候选词
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void CandidateBar::changeEvent(QEvent *event)
+{
+    if(event->type() == QEvent::FontChange)
+    {
+        textWidthCache.clear();
+        relayoutItems();
+    }
+    if(event->type() == QEvent::FontChange || event->type() == QEvent::PaletteChange
+            || event->type() == QEvent::StyleChange)
+    {
+        update();
+    }
+    QWidget::changeEvent(event);
+}
+/*
+ *@brief:   惯性滚动，速度按固定比例衰减，滚动到两端或速度足够小时停止
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void CandidateBar::kineticScrollSlot()
+{
+    int oldOffset = scrollOffset;
+    scrollTo(scrollOffset+qRound(velocity*KINETICINTERVAL));
+    velocity *= KINETICFRICTION;
+    if(scrollOffset == oldOffset || qAbs(velocity) < MINKINETICVELOCITY)
+    {
+        kineticTimer->stop();
+    }
+}
+/*
+ *@brief:   获取文字宽度。同一文字的宽度只测量一次，候选词多为常用字词，重复出现的比例很高
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   text:文字
+ */
+int CandidateBar::textWidth(const QString &text)
+{
+    QHash<QString,int>::const_iterator it = textWidthCache.constFind(text);
+    if(it != textWidthCache.constEnd())
+    {
+        return it.value();
+    }
+    if(textWidthCache.size() >= MAXWIDTHCACHESIZE)
+    {
+        textWidthCache.clear();
+    }
+    int width = fontMetrics().width(text);
+    textWidthCache.insert(text,width);
+    return width;
+}
+
+int CandidateBar::contentWidth() const
+{
+    if(items.isEmpty())
+    {
+        return 0;
+    }
+    return items.last().left+items.last().width;
+}
+/*
+ *@brief:   获取横坐标处的候选词，候选词首尾相接且按位置有序，二分查找
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   x:部件坐标中的横坐标
+ *@return:  候选词序号，没有候选词时为-1
+ */
+int CandidateBar::itemAt(int x) const
+{
+    int contentX = x+scrollOffset;
+    if(contentX < 0 || contentX >= contentWidth())
+    {
+        return -1;
+    }
+    QVector<Item>::const_iterator it = std::upper_bound(items.constBegin(),items.constEnd(),contentX,lessItemLeft<Item>);
+    return int(it-items.constBegin())-1;
+}
+
+QRect CandidateBar::itemRect(int index) const
+{
+    const Item &item = items.at(index);
+    return QRect(item.left-scrollOffset,0,item.width,height());
+}
+
+void CandidateBar::relayoutItems()
+{
+    int left = 0;
+    for(int i=0;i<items.size();i++)
+    {
+        items[i].left = left;
+        items[i].width = textWidth(items.at(i).text)+2*ITEMPADDING;
+        left += items.at(i).width;
+    }
+    scrollTo(scrollOffset);
+}
+/*
+ *@brief:   滚动到指定位置。已绘制的内容直接移动，只重绘露出的部分
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   offset:内容的滚动位置，超出范围时限制在两端
+ */
+void CandidateBar::scrollTo(int offset)
+{
+    offset = qBound(0,offset,qMax(0,contentWidth()-width()));
+    int dx = scrollOffset-offset;
+    if(dx == 0)
+    {
+        return;
+    }
+    scrollOffset = offset;
+    scroll(dx,0);
+    fetchIfNeeded();
+}
+/*
+ *@brief:   已获取的候选词排不满可见范围之后的几屏时，请求更多的候选词。
+ * 接收者在信号的响应中同步追加，追加不到新的候选词时停止请求
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void CandidateBar::fetchIfNeeded()
+{
+    if(isFetching)
+    {
+        return;
+    }
+    isFetching = true;
+    while(hasMoreCandidates && contentWidth() < scrollOffset+width()*FETCHAHEADSCREENS)
+    {
+        int oldCount = items.size();
+        emit moreCandidatesRequested();
+        if(items.size() == oldCount)
+        {
+            break;
+        }
+    }
+    isFetching = false;
+}
@@ -0,0 +1,90 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  候选条，自绘的水平候选词列表。候选词按实际文字宽度(缓存)依次排列，一行能放下
+ * 多少就显示多少；候选词按需分批获取，拖动时惯性滚动，重绘只绘制可见范围内的候选词
+ */
+#ifndef CANDIDATEBAR_H
+#define CANDIDATEBAR_H
+
+#include <QWidget>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "textpixmapcache.h"
+#include "latencyhistogram.h"
+
+class CandidateBar : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit CandidateBar(TextPixmapCache *cache,QWidget *parent = 0);
+
+    void clear();//清空候选词并回到起始位置
+    void appendCandidates(const QStringList &candidateList,bool hasMore);//追加一批候选词
+    int count() const;//已获取的候选词个数
+    QString candidate(int index) const;
+    int firstVisibleIndex() const;//第一个完整显示的候选词，用于按序号选词
+    LatencyHistogram paintStatistics() const;//绘制耗时分布
+    void resetPaintStatistics();
+
+signals:
+    void candidateClicked(QString candidate);//候选词被点击
+    void moreCandidatesRequested();//需要更多候选词，接收者调用appendCandidates追加
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+    void mouseMoveEvent(QMouseEvent *event);
+    void mouseReleaseEvent(QMouseEvent *event);
+    void resizeEvent(QResizeEvent *event);
+    void changeEvent(QEvent *event);
+
+private slots:
+    void kineticScrollSlot();//惯性滚动
+
+private:
+    //候选词项 left为相对于内容起点的横坐标
+    struct Item
+    {
+        QString text;
+        int left;
+        int width;
+    };
+
+    int textWidth(const QString &text);//文字宽度，按文字缓存
+    int contentWidth() const;
+    int itemAt(int x) const;//横坐标(部件坐标)处的候选词
+    QRect itemRect(int index) const;//候选词在部件中的区域
+    void relayoutItems();//字体改变后重新计算所有候选词的位置
+    void scrollTo(int offset);
+    void fetchIfNeeded();//可见范围之后的候选词不足时请求更多
+
+    TextPixmapCache *textCache;
+    QVector<Item> items;
+    QHash<QString,int> textWidthCache;
+    bool hasMoreCandidates;
+    bool isFetching;//正在请求候选词，避免重入
+    int scrollOffset;//内容的滚动位置
+    //拖动及惯性滚动
+    int pressedIndex;//按下的候选词，-1表示无
+    int pressX;
+    int pressOffset;
+    bool isDragging;
+    int lastMoveX;
+    QElapsedTimer moveTimer;
+    qreal velocity;//滚动速度(像素/ms)
+    QTimer *kineticTimer;
+    LatencyHistogram paintHistogram;//绘制耗时
+};
+
+#endif // CANDIDATEBAR_H
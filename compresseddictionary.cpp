@@ -0,0 +1,532 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  分块压缩的拼音字典。拼音-汉字列表按拼音排序后分块，每块用zlib(qCompress)单独压缩，
+ * 文件头部是各块首个拼音及偏移组成的小索引。打开时只读入索引，查询时定位到拼音所在的块，
+ * 只解压该块，节省flash空间和启动时间。
+ * 字典按拼音首字母分片，块不跨越首字母，文件以内存映射方式访问。解压后的块作为页面放在所有
+ * 压缩字典共用的页面缓存中，缓存总大小受内存预算限制，超出时淘汰最久未使用的页面。
+ */
+#include "compresseddictionary.h"
+#include <QDataStream>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QCache>
+#include <QPair>
+#include <QSet>
+#include <QDebug>
+
+#define COMPRESSEDDICTMAGIC     0x50595A44  //压缩字典文件标识"PYZD"
+#define COMPRESSEDDICTVERSION   2           //压缩字典文件版本 2:整句解码词表每个全拼保存多个词
+#define DEFAULTMEMORYBUDGET     (256*1024)  //默认页面缓存内存预算(字节)
+#define PAGEENTRYOVERHEAD       32          //页面中每个字符串的估算额外开销(字节)
+
+typedef QHash<QString,QStringList> DictionaryPage;//解压后的块 拼音-汉字列表
+typedef QPair<const CompressedDictionary *,int> PageKey;//(字典,块序号)
+//所有压缩字典共用的页面缓存，QCache按最久未使用的顺序淘汰，代价为页面的估算内存
+static QMutex pageMutex;
+static QCache<PageKey,DictionaryPage> pageCache(DEFAULTMEMORYBUDGET);
+static CompressedDictionary::Statistics pageStats;
+static quint64 pageInsertCount = 0;//放入缓存的页面数
+static quint64 pageRemoveCount = 0;//字典释放时移除的页面数
+
+CompressedDictionary::CompressedDictionary()
+    :mappedData(0),fileSize(0),dataStart(0),decoderOffset(0),decoderSize(0),openNsecs(0)
+{
+}
+/*
+ *@brief:   析构时从页面缓存移除本字典的页面，解除文件映射
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+CompressedDictionary::~CompressedDictionary()
+{
+    QMutexLocker locker(&pageMutex);
+    QList<PageKey> keyList = pageCache.keys();
+    for(int i=0;i<keyList.size();i++)
+    {
+        if(keyList.at(i).first == this)
+        {
+            pageCache.remove(keyList.at(i));
+            pageRemoveCount++;
+        }
+    }
+    locker.unlock();
+    if(mappedData)
+    {
+        dictFile.unmap(mappedData);
+    }
+}
+/*
+ *@brief:   打开压缩字典文件，只读入文件头和块索引，然后映射整个文件，块数据在查询时
+ * 由内核按需调入。映射失败时退回按需读取文件。文件保持打开，直到字典释放
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:压缩字典文件路径
+ *@return:  文件是否打开成功且格式正确
+ */
+bool CompressedDictionary::open(const QString &filePath)
+{
+    QElapsedTimer timer;
+    timer.start();
+    dictFilePath = filePath;
+    dictFile.setFileName(filePath);
+    if(!dictFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QDataStream in(&dictFile);
+    in.setVersion(QDataStream::Qt_4_6);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    in>>magic>>version;
+    if(magic != COMPRESSEDDICTMAGIC || version != COMPRESSEDDICTVERSION)
+    {
+        qDebug()<<"CompressedDictionary:Unsupported file"<<filePath;
+        dictFile.close();
+        return false;
+    }
+    in>>count;
+    blockIndex.resize(count);
+    for(quint32 i=0;i<count;i++)
+    {
+        in>>blockIndex[i].firstKey>>blockIndex[i].offset>>blockIndex[i].size;
+    }
+    in>>decoderOffset>>decoderSize;
+    if(in.status() != QDataStream::Ok)
+    {
+        qDebug()<<"CompressedDictionary:Corrupted index"<<filePath;
+        blockIndex.clear();
+        dictFile.close();
+        return false;
+    }
+    dataStart = dictFile.pos();
+    fileSize = dictFile.size();
+    mappedData = dictFile.map(0,fileSize);
+    if(!mappedData)
+    {
+        qDebug()<<"CompressedDictionary:Failed to map"<<filePath<<",fall back to reading";
+    }
+    openNsecs = timer.nsecsElapsed();
+    return true;
+}
+/*
+ *@brief:   获取字典的加载统计。打开时只读入块索引，字词按需解压，所以只有块索引的内存和
+ * 读取耗时，条数等规模统计为0，页面缓存的内存见statistics()
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+DictionaryIndex::LoadStatistics CompressedDictionary::loadStatistics() const
+{
+    LoadStatistics stats = {0,0,0,0,0,0,0,0,0};
+    stats.indexBytes = qint64(blockIndex.capacity())*sizeof(BlockEntry);
+    for(int i=0;i<blockIndex.size();i++)
+    {
+        stats.stringBytes += PAGEENTRYOVERHEAD+blockIndex.at(i).firstKey.size()*sizeof(QChar);
+    }
+    stats.readNsecs = openNsecs;
+    return stats;
+}
+/*
+ *@brief:   获取拼音对应的汉字列表，顺序与文本字典构建的哈希表一致，常用词在列表后面。
+ * 只解压拼音所在的一个块作为页面放入缓存，解压在缓存锁之外进行，不阻塞其他字典的查询
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:拼音
+ */
+QList<QString> CompressedDictionary::values(const QString &pinyin) const
+{
+    int index = findBlock(pinyin);
+    if(index < 0)
+    {
+        return QList<QString>();
+    }
+    PageKey pageKey(this,index);
+    QMutexLocker locker(&pageMutex);
+    pageStats.lookupCount++;
+    DictionaryPage *page = pageCache.object(pageKey);
+    if(page)
+    {
+        pageStats.cacheHitCount++;
+        return page->value(pinyin);
+    }
+    locker.unlock();
+    QElapsedTimer timer;
+    timer.start();
+    page = new DictionaryPage();
+    int bytes = 0;
+    if(!readBlock(index,*page,bytes))
+    {
+        delete page;
+        return QList<QString>();
+    }
+    qint64 nsecs = timer.nsecsElapsed();
+    QStringList valueList = page->value(pinyin);
+    locker.relock();
+    pageStats.pageInLatency.add(nsecs);
+    if(pageCache.contains(pageKey))//其他线程在解压期间已放入同一页面，保留已有的页面
+    {
+        pageCache.object(pageKey);//更新最近使用的顺序
+        delete page;
+        return valueList;
+    }
+    pageInsertCount++;
+    pageCache.insert(pageKey,page,bytes);//缓存接管页面的内存，超出预算时淘汰最久未使用的页面
+    return valueList;
+}
+/*
+ *@brief:   获取所有拼音(不重复)。需要依次解压所有块，只在后台构建纠错字典树时使用，
+ * 解压的块不放入页面缓存，避免挤掉正在使用的页面
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+QList<QString> CompressedDictionary::keys() const
+{
+    QList<QString> keyList;
+    for(int i=0;i<blockIndex.size();i++)
+    {
+        DictionaryPage page;
+        int bytes = 0;
+        if(readBlock(i,page,bytes))
+        {
+            keyList.append(page.keys());
+        }
+    }
+    return keyList;
+}
+/*
+ *@brief:   遍历所有拼音及其汉字列表，用于后台构建派生索引。与keys()一样逐块解压到临时页面，
+ * 不放入页面缓存，不会挤掉界面线程正在使用的页面，也不受内存预算限制
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   visitor:访问者
+ */
+void CompressedDictionary::visitEntries(DictionaryVisitor &visitor) const
+{
+    for(int i=0;i<blockIndex.size();i++)
+    {
+        DictionaryPage page;
+        int bytes = 0;
+        if(!readBlock(i,page,bytes))
+        {
+            continue;
+        }
+        DictionaryPage::const_iterator it = page.constBegin();
+        for(;it!=page.constEnd();++it)
+        {
+            visitor.visit(it.key(),it.value());
+        }
+    }
+}
+/*
+ *@brief:   获取整句解码词表。词表单独压缩存放，只在整句模式首次使用时解压，
+ * 不计入页面缓存的内存预算
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+const SentenceDecoder *CompressedDictionary::sentenceDecoder() const
+{
+    QMutexLocker locker(&mutex);
+    if(!decoder.isNull())
+    {
+        return decoder.data();
+    }
+    if(decoderSize == 0)
+    {
+        return 0;
+    }
+    QByteArray data = uncompressSection(decoderOffset,decoderSize);
+    if(data.isEmpty())
+    {
+        qDebug()<<"CompressedDictionary:Corrupted decoder table"<<dictFilePath;
+        return 0;
+    }
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_4_6);
+    decoder.reset(new SentenceDecoder());
+    decoder->loadWordTable(in);
+    return decoder.data();
+}
+
+QString CompressedDictionary::filePath() const
+{
+    return dictFilePath;
+}
+
+int CompressedDictionary::blockCount() const
+{
+    return blockIndex.size();
+}
+/*
+ *@brief:   首字母分片数
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+int CompressedDictionary::shardCount() const
+{
+    QSet<QString> shardSet;
+    for(int i=0;i<blockIndex.size();i++)
+    {
+        shardSet.insert(blockIndex.at(i).firstKey.left(1));
+    }
+    return shardSet.size();
+}
+/*
+ *@brief:   设置页面缓存的内存预算，所有压缩字典共用。预算减小时立即淘汰最久未使用的页面
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   bytes:内存预算(字节)
+ */
+void CompressedDictionary::setMemoryBudget(int bytes)
+{
+    QMutexLocker locker(&pageMutex);
+    pageCache.setMaxCost(qMax(0,bytes));
+}
+
+int CompressedDictionary::memoryBudget()
+{
+    QMutexLocker locker(&pageMutex);
+    return pageCache.maxCost();
+}
+/*
+ *@brief:   获取页面缓存统计，驻留情况为调用时的快照
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+CompressedDictionary::Statistics CompressedDictionary::statistics()
+{
+    QMutexLocker locker(&pageMutex);
+    Statistics stats = pageStats;
+    QList<PageKey> keyList = pageCache.keys();
+    QSet<QPair<const CompressedDictionary *,QString> > shardSet;
+    for(int i=0;i<keyList.size();i++)
+    {
+        const CompressedDictionary *dictionary = keyList.at(i).first;
+        shardSet.insert(qMakePair(dictionary,dictionary->blockIndex.at(keyList.at(i).second).firstKey.left(1)));
+    }
+    stats.residentPages = pageCache.count();
+    stats.residentShards = shardSet.size();
+    stats.residentBytes = pageCache.totalCost();
+    stats.memoryBudget = pageCache.maxCost();
+    //页面只会被淘汰或随字典释放而移除
+    stats.evictionCount = pageInsertCount-pageRemoveCount-pageCache.count();
+    return stats;
+}
+/*
+ *@brief:   清零累计统计，驻留的页面不受影响
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void CompressedDictionary::resetStatistics()
+{
+    QMutexLocker locker(&pageMutex);
+    pageStats.lookupCount = 0;
+    pageStats.cacheHitCount = 0;
+    pageStats.pageInLatency.clear();
+    pageInsertCount = pageCache.count();
+    pageRemoveCount = 0;
+}
+/*
+ *@brief:   判断文件是否为压缩字典(检查文件标识)
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:文件路径
+ */
+bool CompressedDictionary::isCompressedFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QDataStream in(&file);
+    quint32 magic = 0;
+    in>>magic;
+    return magic == COMPRESSEDDICTMAGIC;
+}
+/*
+ *@brief:   由已加载的字典生成压缩字典文件。拼音排序后依次写入块，块未压缩的大小达到blockSize
+ * 或拼音首字母改变时开始新的块，使每个首字母分片由整数个块组成；整句解码词表单独压缩写在最后。先写临时文件，完成后再替换，避免正在使用该
+ * 文件的键盘读到写了一半的文件
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:压缩字典文件路径
+ *@param:   source:源字典
+ *@param:   blockSize:每块未压缩的大致字节数，越小查询解压越快，压缩率越低
+ *@return:  文件是否写入成功
+ */
+bool CompressedDictionary::write(const QString &filePath, const DictionaryIndex &source, int blockSize)
+{
+    QStringList keyList = source.keys();
+    keyList.sort();
+    //分块压缩 块数据为记录数+各条记录(拼音,汉字列表)
+    QList<QString> firstKeyList;
+    QList<QByteArray> blockDataList;
+    QByteArray blockData;
+    int blockKeyCount = 0;
+    for(int i=0;i<=keyList.size();i++)
+    {
+        if(i == keyList.size() || blockData.size() >= blockSize ||
+                (blockKeyCount > 0 && keyList.at(i).left(1) != keyList.at(i-blockKeyCount).left(1)))
+        {
+            if(blockKeyCount > 0)
+            {
+                QByteArray rawData;
+                QDataStream rawStream(&rawData,QIODevice::WriteOnly);
+                rawStream.setVersion(QDataStream::Qt_4_6);
+                rawStream<<quint32(blockKeyCount);
+                rawData.append(blockData);
+                firstKeyList.append(keyList.at(i-blockKeyCount));
+                blockDataList.append(qCompress(rawData));
+            }
+            blockData.clear();
+            blockKeyCount = 0;
+            if(i == keyList.size())
+            {
+                break;
+            }
+        }
+        QByteArray recordData;
+        QDataStream recordStream(&recordData,QIODevice::WriteOnly);
+        recordStream.setVersion(QDataStream::Qt_4_6);
+        recordStream<<keyList.at(i)<<QStringList(source.values(keyList.at(i)));
+        blockData.append(recordData);
+        blockKeyCount++;
+    }
+    QByteArray decoderData;
+    if(source.sentenceDecoder())
+    {
+        QByteArray rawData;
+        QDataStream rawStream(&rawData,QIODevice::WriteOnly);
+        rawStream.setVersion(QDataStream::Qt_4_6);
+        source.sentenceDecoder()->saveWordTable(rawStream);
+        decoderData = qCompress(rawData);
+    }
+    //写文件 文件头+块索引+块数据+整句解码词表
+    QString tempFilePath = filePath+".tmp";
+    QFile file(tempFilePath);
+    if(!file.open(QIODevice::WriteOnly|QIODevice::Truncate))
+    {
+        qDebug()<<"CompressedDictionary:Failed to open"<<tempFilePath;
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_6);
+    out<<quint32(COMPRESSEDDICTMAGIC)<<quint32(COMPRESSEDDICTVERSION)<<quint32(blockDataList.size());
+    quint32 offset = 0;
+    for(int i=0;i<blockDataList.size();i++)
+    {
+        out<<firstKeyList.at(i)<<offset<<quint32(blockDataList.at(i).size());
+        offset += blockDataList.at(i).size();
+    }
+    out<<offset<<quint32(decoderData.size());
+    for(int i=0;i<blockDataList.size();i++)
+    {
+        file.write(blockDataList.at(i));
+    }
+    file.write(decoderData);
+    bool ok = (out.status() == QDataStream::Ok && file.error() == QFile::NoError);
+    file.close();
+    if(!ok)
+    {
+        QFile::remove(tempFilePath);
+        return false;
+    }
+    QFile::remove(filePath);
+    return QFile::rename(tempFilePath,filePath);
+}
+/*
+ *@brief:   二分查找拼音所在的块，即首个拼音不大于该拼音的最后一个块
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:拼音
+ *@return:  块序号，拼音小于所有块的首个拼音时返回-1
+ */
+int CompressedDictionary::findBlock(const QString &pinyin) const
+{
+    int low = 0;
+    int high = blockIndex.size();
+    while(low < high)
+    {
+        int mid = (low+high)/2;
+        if(pinyin < blockIndex.at(mid).firstKey)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid+1;
+        }
+    }
+    return low-1;
+}
+/*
+ *@brief:   读取并解压一个块，同时估算解压后占用的内存
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   index:块序号
+ *@param:   block:解压后的块
+ *@param:   bytes:估算的内存(字节)
+ *@return:  是否成功
+ */
+bool CompressedDictionary::readBlock(int index, QHash<QString,QStringList> &block, int &bytes) const
+{
+    const BlockEntry &entry = blockIndex.at(index);
+    QByteArray data = uncompressSection(entry.offset,entry.size);
+    if(data.isEmpty())
+    {
+        qDebug()<<"CompressedDictionary:Corrupted block"<<index<<dictFilePath;
+        return false;
+    }
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_4_6);
+    quint32 count = 0;
+    in>>count;
+    block.reserve(count);
+    bytes = 0;
+    for(quint32 i=0;i<count && in.status()==QDataStream::Ok;i++)
+    {
+        QString key;
+        QStringList valueList;
+        in>>key>>valueList;
+        bytes += key.size()*sizeof(QChar)+PAGEENTRYOVERHEAD;
+        for(int j=0;j<valueList.size();j++)
+        {
+            bytes += valueList.at(j).size()*sizeof(QChar)+PAGEENTRYOVERHEAD;
+        }
+        block.insert(key,valueList);
+    }
+    return in.status() == QDataStream::Ok;
+}
+/*
+ *@brief:   解压数据区的一段。文件已映射时直接从映射的内存解压，不复制压缩数据
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   offset:相对数据区起始的偏移
+ *@param:   size:压缩后的字节数
+ *@return:  解压后的数据，越界或数据损坏时为空
+ */
+QByteArray CompressedDictionary::uncompressSection(quint32 offset, quint32 size) const
+{
+    if(dataStart+offset+size > fileSize)
+    {
+        return QByteArray();
+    }
+    if(mappedData)
+    {
+        return qUncompress(mappedData+dataStart+offset,size);
+    }
+    QMutexLocker locker(&fileMutex);
+    if(!dictFile.seek(dataStart+offset))
+    {
+        return QByteArray();
+    }
+    return qUncompress(dictFile.read(size));
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  分块压缩的拼音字典。拼音-汉字列表按拼音排序后分块，每块用zlib(qCompress)单独压缩，
+ * 文件头部是各块首个拼音及偏移组成的小索引。打开时只读入索引，查询时定位到拼音所在的块，
+ * 只解压该块，节省flash空间和启动时间。
+ * 字典按拼音首字母分片，块不跨越首字母，文件以内存映射方式访问。解压后的块作为页面放在所有
+ * 压缩字典共用的页面缓存中，缓存总大小受内存预算限制，超出时淘汰最久未使用的页面。
+ */
+#ifndef COMPRESSEDDICTIONARY_H
+#define COMPRESSEDDICTIONARY_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QFile>
+#include <QMutex>
+#include <QScopedPointer>
+#include "dictionaryindex.h"
+#include "latencyhistogram.h"
+#include "sentencedecoder.h"
+
+class CompressedDictionary : public DictionaryIndex
+{
+public:
+    //页面缓存统计，所有压缩字典共用
+    struct Statistics
+    {
+        quint64 lookupCount;//查询次数
+        quint64 cacheHitCount;//命中已驻留页面的次数
+        quint64 evictionCount;//因超出内存预算淘汰的页面数
+        int residentPages;//驻留的页面数
+        int residentShards;//有页面驻留的分片(字典,首字母)数
+        int residentBytes;//驻留页面的估算内存(字节)
+        int memoryBudget;//内存预算(字节)
+        LatencyHistogram pageInLatency;//读取并解压页面的耗时分布，记录次数即读取页面的次数
+    };
+
+    CompressedDictionary();
+    ~CompressedDictionary();
+
+    bool open(const QString &filePath);//打开压缩字典文件，只读入块索引
+    QList<QString> values(const QString &pinyin) const;//获取拼音对应的汉字列表
+    QList<QString> keys() const;//所有拼音(不重复)
+    const SentenceDecoder *sentenceDecoder() const;//整句解码词表，首次使用时解压
+    LoadStatistics loadStatistics() const;//块索引的内存及读取耗时
+    void visitEntries(DictionaryVisitor &visitor) const;//逐块解压遍历，不进入页面缓存
+    QString filePath() const;
+    int blockCount() const;
+    int shardCount() const;//首字母分片数
+
+    static void setMemoryBudget(int bytes);//设置页面缓存的内存预算
+    static int memoryBudget();
+    static Statistics statistics();
+    static void resetStatistics();
+    static bool isCompressedFile(const QString &filePath);//判断文件是否为压缩字典
+    static bool write(const QString &filePath,const DictionaryIndex &source,int blockSize=4096);//由字典生成压缩字典文件
+
+private:
+    //块索引项
+    struct BlockEntry
+    {
+        QString firstKey;//块中最小的拼音
+        quint32 offset;//块数据相对数据区起始的偏移
+        quint32 size;//压缩后的大小
+    };
+
+    int findBlock(const QString &pinyin) const;//拼音所在的块
+    bool readBlock(int index,QHash<QString,QStringList> &block,int &bytes) const;//读取并解压一个块
+    QByteArray uncompressSection(quint32 offset,quint32 size) const;//解压数据区的一段
+
+    QString dictFilePath;
+    mutable QFile dictFile;
+    uchar *mappedData;//映射的文件内容，映射失败时退回文件读取
+    qint64 fileSize;
+    qint64 dataStart;//数据区在文件中的起始位置
+    QVector<BlockEntry> blockIndex;//块索引，按首个拼音排序
+    quint32 decoderOffset;//整句解码词表在数据区的偏移
+    quint32 decoderSize;
+    qint64 openNsecs;//打开及读入块索引的耗时(ns)
+    //以下成员在查询时修改，查询可能来自界面线程和后台线程，用互斥锁保护
+    mutable QMutex fileMutex;//未映射时保护文件读取位置
+    mutable QMutex mutex;//保护整句解码词表的延迟加载
+    mutable QScopedPointer<SentenceDecoder> decoder;
+};
+
+#endif // COMPRESSEDDICTIONARY_H
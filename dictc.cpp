@@ -0,0 +1,423 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  拼音字典编译工具，在构建环境中预处理拼音字典，不在设备上进行。
+ * 读取ChinesePinyin格式的文本字典(每行"汉字拼音[ 词频]"，词组拼音用'分隔，也可以是
+ * ChinesePinyin-Unsupported phrases中不带分隔的写法)，检查格式错误的行、重复的词条及
+ * 非法音节，合并重复词条的词频，输出设备使用的分块压缩字典(.pyz)及规范化的文本字典，
+ * 并报告词条数、键展开倍数及预计的内存占用和加载时间。
+ *
+ * 用法: dictc [选项] 输入文件...
+ *   -o <文件>          输出的压缩字典，默认ChinesePinyin.pyz
+ *   -t <文件>          同时输出规范化的文本字典
+ *   -b <字节>          压缩块大小，默认4096
+ *   --check            只检查和报告，不输出文件
+ *   --strict           存在错误行或非法音节时返回非0
+ *   --keep-illegal     保留含非法音节的词条(默认丢弃)
+ *   --device-scale <n> 设备与本机的速度比，用于估算设备上的加载时间，默认1
+ */
+#include <QCoreApplication>
+#include <QStringList>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QRegExp>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QTemporaryFile>
+#include <algorithm>
+#include "pinyinsyllable.h"
+#include "pinyindictionary.h"
+#include "compresseddictionary.h"
+
+#define DEFAULTOUTPUTPATH   "ChinesePinyin.pyz"
+#define DEFAULTBLOCKSIZE    4096
+#define MAXREPORTEDLINES    20      //每类问题最多逐行报告的行数
+#define MAXEXPANDEDSYLLABLES 4      //拼音字典展开简拼的最大字数，更长的词组只用于整句解码
+#define HASHNODEBYTES       32      //哈希表节点(next、hash、键值QString)的估算大小
+#define STRINGHEADERBYTES   24      //QString数据头的估算大小
+
+//词条
+struct DictEntry
+{
+    QString chinese;
+    QString pinyin;//规范化后的拼音，词组用'分隔
+    quint32 frequency;//合并后的词频，未标注词频时为0
+    int order;//首次出现的顺序，词频相同时靠前的排在前面
+};
+
+//检查结果
+struct CheckReport
+{
+    int lineCount;
+    int blankCount;
+    int malformedCount;
+    int illegalCount;
+    int duplicateCount;
+    int normalizedCount;//补全了音节分隔的词组数
+    int bomCount;
+};
+
+static QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+static QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+static void printUsage()
+{
+    err()<<"usage: dictc [-o out.pyz] [-t out.txt] [-b blockSize] [--check] [--strict]\n"
+           "             [--keep-illegal] [--device-scale n] input...\n";
+    err().flush();
+}
+/*
+ *@brief:   逐行报告问题，每类问题只报告前几行，避免输出过多
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static void reportLine(int count,const QString &kind,const QString &filePath,int lineNumber,const QString &lineText)
+{
+    if(count <= MAXREPORTEDLINES)
+    {
+        err()<<filePath<<":"<<lineNumber<<": "<<kind<<": "<<lineText<<"\n";
+    }
+    else if(count == MAXREPORTEDLINES+1)
+    {
+        err()<<filePath<<": more "<<kind<<" lines omitted\n";
+    }
+}
+/*
+ *@brief:   规范化并检查拼音。单字的拼音可以是完整音节或音节的开头；词组的拼音没有'分隔时
+ * 按音节切分补全，每个音节必须合法，音节数必须与汉字数一致
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   chinese:汉字
+ *@param:   pinyin:拼音，规范化后写回
+ *@param:   isNormalized:是否补全了音节分隔
+ *@return:  拼音是否合法
+ */
+static bool normalizePinyin(const QString &chinese,QString &pinyin,bool &isNormalized)
+{
+    isNormalized = false;
+    QStringList syllableList;
+    if(pinyin.contains("'"))
+    {
+        syllableList = pinyin.split("'");
+    }
+    else if(chinese.length() > 1)
+    {
+        syllableList = PinyinSyllable::split(pinyin);
+        isNormalized = true;
+    }
+    else//单字可以只写拼音的开头(如"不b")，作为该字的简拼
+    {
+        return PinyinSyllable::isSyllablePrefix(pinyin);
+    }
+    if(syllableList.size() != chinese.length())
+    {
+        return false;
+    }
+    for(int i=0;i<syllableList.size();i++)
+    {
+        if(!PinyinSyllable::isSyllable(syllableList.at(i)))
+        {
+            return false;
+        }
+    }
+    pinyin = syllableList.join("'");
+    return true;
+}
+/*
+ *@brief:   读取一个文本字典，检查每一行并合并到词条表中。同一汉字和拼音的词条只保留一条，
+ * 词频相加
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static bool readDictionaryFile(const QString &filePath,bool keepIllegal,QVector<DictEntry> &entries,
+                               QHash<QString,int> &entryIndex,CheckReport &report)
+{
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        err()<<filePath<<": cannot open\n";
+        return false;
+    }
+    QRegExp lineExp("([^a-z'\\s]+)([a-z']+)(?:\\s+(\\d+))?\\s*");
+    int lineNumber = 0;
+    while(!file.atEnd())
+    {
+        QString lineText = QString::fromUtf8(file.readLine());
+        lineNumber++;
+        report.lineCount++;
+        if(lineText.startsWith(QChar(0xFEFF)))//UTF-8 BOM会被当作首行汉字的一部分
+        {
+            lineText.remove(0,1);
+            report.bomCount++;
+        }
+        QString trimmedText = lineText.trimmed();
+        if(trimmedText.isEmpty())
+        {
+            report.blankCount++;
+            continue;
+        }
+        if(!lineExp.exactMatch(trimmedText) || lineExp.cap(2).startsWith("'") || lineExp.cap(2).endsWith("'")
+                || lineExp.cap(2).contains("''"))
+        {
+            report.malformedCount++;
+            reportLine(report.malformedCount,"malformed",filePath,lineNumber,trimmedText);
+            continue;
+        }
+        DictEntry entry;
+        entry.chinese = lineExp.cap(1);
+        entry.pinyin = lineExp.cap(2);
+        entry.frequency = lineExp.cap(3).toUInt();
+        bool isNormalized = false;
+        if(!normalizePinyin(entry.chinese,entry.pinyin,isNormalized))
+        {
+            report.illegalCount++;
+            reportLine(report.illegalCount,"illegal syllables",filePath,lineNumber,trimmedText);
+            if(!keepIllegal)
+            {
+                continue;
+            }
+        }
+        else if(isNormalized)
+        {
+            report.normalizedCount++;
+        }
+        QString key = entry.chinese+" "+entry.pinyin;
+        QHash<QString,int>::const_iterator it = entryIndex.constFind(key);
+        if(it != entryIndex.constEnd())
+        {
+            report.duplicateCount++;
+            entries[it.value()].frequency += entry.frequency;
+            continue;
+        }
+        entry.order = entries.size();
+        entryIndex.insert(key,entries.size());
+        entries.append(entry);
+    }
+    return true;
+}
+/*
+ *@brief:   词条排序，词频高的在前，词频相同时保持首次出现的顺序。
+ * 字典文件中靠前的词条在候选词中靠前，未标注词频时顺序不变
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static bool lessEntry(const DictEntry &left,const DictEntry &right)
+{
+    if(left.frequency != right.frequency)
+    {
+        return left.frequency > right.frequency;
+    }
+    return left.order < right.order;
+}
+/*
+ *@brief:   写规范化的文本字典，格式与ChinesePinyin一致，不含词频
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static bool writeTextDictionary(QIODevice *device,const QVector<DictEntry> &entries)
+{
+    for(int i=0;i<entries.size();i++)
+    {
+        QByteArray line = (entries.at(i).chinese+entries.at(i).pinyin+"\n").toUtf8();
+        if(device->write(line) != line.size())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+/*
+ *@brief:   QString占用内存的估算，数据头加UTF-16字符及结束符，按8字节对齐
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static qint64 stringBytes(const QString &text)
+{
+    return (STRINGHEADERBYTES+2*(text.length()+1)+7)/8*8;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc,argv);
+    out().setCodec("UTF-8");
+    err().setCodec("UTF-8");
+    QStringList arguments = app.arguments();
+    QString outputPath = DEFAULTOUTPUTPATH;
+    QString textOutputPath;
+    int blockSize = DEFAULTBLOCKSIZE;
+    bool isCheckOnly = false;
+    bool isStrict = false;
+    bool keepIllegal = false;
+    double deviceScale = 1.0;
+    QStringList inputPaths;
+    for(int i=1;i<arguments.size();i++)
+    {
+        QString argument = arguments.at(i);
+        bool hasValue = (i+1<arguments.size());
+        if(argument == "-o" && hasValue)
+        {
+            outputPath = arguments.at(++i);
+        }
+        else if(argument == "-t" && hasValue)
+        {
+            textOutputPath = arguments.at(++i);
+        }
+        else if(argument == "-b" && hasValue)
+        {
+            blockSize = qMax(256,arguments.at(++i).toInt());
+        }
+        else if(argument == "--device-scale" && hasValue)
+        {
+            deviceScale = qMax(0.01,arguments.at(++i).toDouble());
+        }
+        else if(argument == "--check")
+        {
+            isCheckOnly = true;
+        }
+        else if(argument == "--strict")
+        {
+            isStrict = true;
+        }
+        else if(argument == "--keep-illegal")
+        {
+            keepIllegal = true;
+        }
+        else if(argument.startsWith("-"))
+        {
+            printUsage();
+            return 2;
+        }
+        else
+        {
+            inputPaths.append(argument);
+        }
+    }
+    if(inputPaths.isEmpty())
+    {
+        printUsage();
+        return 2;
+    }
+    /*****************读取、检查并合并*****************/
+    QElapsedTimer timer;
+    timer.start();
+    CheckReport report = {0,0,0,0,0,0,0};
+    QVector<DictEntry> entries;
+    QHash<QString,int> entryIndex;
+    for(int i=0;i<inputPaths.size();i++)
+    {
+        if(!readDictionaryFile(inputPaths.at(i),keepIllegal,entries,entryIndex,report))
+        {
+            return 1;
+        }
+    }
+    std::stable_sort(entries.begin(),entries.end(),lessEntry);
+    qint64 checkMsecs = timer.elapsed();
+    int phraseCount = 0;
+    int longPhraseCount = 0;
+    for(int i=0;i<entries.size();i++)
+    {
+        if(entries.at(i).chinese.length() > 1)
+        {
+            phraseCount++;
+        }
+        if(entries.at(i).chinese.length() > MAXEXPANDEDSYLLABLES)
+        {
+            longPhraseCount++;
+        }
+    }
+    out()<<"lines:              "<<report.lineCount<<" ("<<report.blankCount<<" blank)\n";
+    out()<<"malformed lines:    "<<report.malformedCount<<"\n";
+    out()<<"illegal syllables:  "<<report.illegalCount<<(keepIllegal?" (kept)":" (dropped)")<<"\n";
+    out()<<"duplicate entries:  "<<report.duplicateCount<<" (frequencies merged)\n";
+    out()<<"normalized phrases: "<<report.normalizedCount<<"\n";
+    if(report.bomCount > 0)
+    {
+        out()<<"byte order marks:   "<<report.bomCount<<" (stripped)\n";
+    }
+    out()<<"entries:            "<<entries.size()<<" ("<<entries.size()-phraseCount<<" characters, "
+        <<phraseCount<<" phrases, "<<longPhraseCount<<" only used by the sentence decoder)\n";
+    out()<<"check time:         "<<checkMsecs<<" ms\n";
+    out().flush();
+    bool hasErrors = (report.malformedCount>0 || report.illegalCount>0);
+    if(isCheckOnly)
+    {
+        return (isStrict && hasErrors)?1:0;
+    }
+    /*****************按设备的加载方式构建字典，统计键展开*****************/
+    QTemporaryFile normalizedFile;
+    if(!normalizedFile.open() || !writeTextDictionary(&normalizedFile,entries) || !normalizedFile.flush())
+    {
+        err()<<"cannot write temporary file\n";
+        return 1;
+    }
+    normalizedFile.close();
+    PinyinDictionary dictionary;
+    timer.restart();
+    dictionary.load(normalizedFile.fileName());
+    qint64 textLoadMsecs = timer.elapsed();
+    QList<QString> keyList = dictionary.keys();
+    qint64 pairCount = 0;
+    qint64 hashBytes = 0;
+    for(int i=0;i<keyList.size();i++)
+    {
+        QList<QString> valueList = dictionary.values(keyList.at(i));
+        pairCount += valueList.size();
+        for(int j=0;j<valueList.size();j++)
+        {
+            hashBytes += HASHNODEBYTES+stringBytes(keyList.at(i))+stringBytes(valueList.at(j))+sizeof(void *);
+        }
+    }
+    out()<<"unique keys:        "<<keyList.size()<<"\n";
+    out()<<"key-value pairs:    "<<pairCount<<"\n";
+    out()<<"expansion factor:   "<<QString::number(entries.isEmpty()?0.0:double(pairCount)/entries.size(),'f',2)<<"\n";
+    out()<<"text index memory:  ~"<<hashBytes/1024<<" KB (hash table, excluding sentence decoder)\n";
+    out()<<"text load time:     "<<textLoadMsecs<<" ms here, ~"<<qRound64(textLoadMsecs*deviceScale)<<" ms on device\n";
+    /*****************输出*****************/
+    if(!textOutputPath.isEmpty())
+    {
+        QFile textFile(textOutputPath);
+        if(!textFile.open(QIODevice::WriteOnly|QIODevice::Truncate) || !writeTextDictionary(&textFile,entries))
+        {
+            err()<<textOutputPath<<": cannot write\n";
+            return 1;
+        }
+    }
+    if(!CompressedDictionary::write(outputPath,dictionary,blockSize))
+    {
+        err()<<outputPath<<": cannot write\n";
+        return 1;
+    }
+    CompressedDictionary compressedDictionary;
+    timer.restart();
+    if(!compressedDictionary.open(outputPath))
+    {
+        err()<<outputPath<<": cannot open the written file\n";
+        return 1;
+    }
+    qint64 openMsecs = timer.elapsed();
+    qint64 fileBytes = QFileInfo(outputPath).size();
+    out()<<"output:             "<<outputPath<<" ("<<fileBytes/1024<<" KB, "<<compressedDictionary.blockCount()
+        <<" blocks, "<<compressedDictionary.shardCount()<<" shards)\n";
+    out()<<"resident memory:    <= "<<CompressedDictionary::memoryBudget()/1024
+        <<" KB page cache (adjustable), file mapped on demand\n";
+    out()<<"compressed open:    "<<openMsecs<<" ms here, ~"<<qRound64(openMsecs*deviceScale)<<" ms on device\n";
+    out().flush();
+    return (isStrict && hasErrors)?1:0;
+}
@@ -0,0 +1,32 @@
+#-------------------------------------------------
+#
+# 拼音字典编译工具，在构建环境中检查、合并拼音字典并生成设备使用的压缩字典
+# 例: dictc -o ChinesePinyin.pyz ChinesePinyin
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = dictc
+CONFIG += console
+CONFIG -= app_bundle
+OBJECTS_DIR = .obj/$$TARGET  #与键盘共用的源文件编译选项不同，中间文件分开存放
+MOC_DIR = .moc/$$TARGET
+TEMPLATE = app
+
+
+SOURCES += dictc.cpp \
+    pinyinsyllable.cpp \
+    sentencedecoder.cpp \
+    pinyindictionary.cpp \
+    compresseddictionary.cpp \
+    latencyhistogram.cpp
+
+HEADERS  += \
+    pinyinsyllable.h \
+    sentencedecoder.h \
+    dictionaryindex.h \
+    pinyindictionary.h \
+    compresseddictionary.h \
+    latencyhistogram.h
@@ -0,0 +1,587 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  字典等价性检查工具。由同一个拼音字典文件分别构建原来的QMultiHash索引(保留最初
+ * readDictionary()/splitPhrase()/matchChinese()的实现作为基准)和现在使用的各种字典索引，
+ * 查询所有拼音及随机生成的前缀，比较候选词的集合和顺序，并对比加载时间及内存占用。
+ * 新索引的结果必须与基准完全一致，或者在保持基准候选词相对顺序的前提下多出候选词(超集)，
+ * 出现缺少或顺序不同的候选词时返回非0。
+ *
+ * 用法: dictdiff [选项] [拼音字典]
+ *   拼音字典            默认./ChinesePinyin
+ *   -z <文件>          同时比较已有的压缩字典(如dictc的输出)，默认只比较由拼音字典生成的压缩字典
+ *   -r <个数>          随机前缀个数，默认10000
+ *   --seed <n>         随机数种子，默认1
+ *   -b <字节>          生成压缩字典的块大小，默认4096
+ */
+#include <QCoreApplication>
+#include <QStringList>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <QRegExp>
+#include <QMultiHash>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QSharedPointer>
+#include <QElapsedTimer>
+#include <QTemporaryFile>
+#include <algorithm>
+#include "pinyindictionary.h"
+#include "compresseddictionary.h"
+#include "layereddictionary.h"
+#include "userdictionary.h"
+
+#define DEFAULTDICTPATH     "./ChinesePinyin"
+#define DEFAULTRANDOMNUM    10000
+#define DEFAULTBLOCKSIZE    4096
+#define MAXRANDOMLETTERS    6       //随机字母串的最大长度
+#define MAXREPORTEDDIFFS    10      //每个索引最多逐条报告的差异数
+#define HASHNODEBYTES       32      //哈希表节点(next、hash、键值QString)的估算大小
+#define STRINGHEADERBYTES   24      //QString数据头的估算大小
+#define USERLAYERRANKBIAS   -1      //用户字典层的排序偏移，与键盘一致
+
+/*基准索引，最初版本键盘的拼音哈希表，代码保持原样不随新索引修改*/
+class LegacyDictionary
+{
+public:
+    bool readDictionary(const QString &filePath);
+    QList<QString> matchChinese(const QString &pinyin) const;
+    QList<QString> keys() const;
+
+private:
+    void splitPhrase(QString phrase,QString chinese);
+
+    QMultiHash<QString,QString> chinesePinyin;
+};
+
+/*分层字典的查询适配，与键盘一样由系统字典层和一个空的用户词典层组成，比较的是多层合并的查询路径。
+ 用户词典指向临时目录下不存在的文件，不学习时不会创建任何文件*/
+class LayeredIndex : public DictionaryIndex
+{
+public:
+    explicit LayeredIndex(QSharedPointer<const DictionaryIndex> systemIndex)
+        :userDictionary(QDir::temp().filePath(QString("dictdiff-user-%1").arg(QCoreApplication::applicationPid())))
+    {
+        layeredDictionary.setLayer("system",systemIndex);
+        layeredDictionary.setLayer("user",QSharedPointer<const DictionaryIndex>(&userDictionary,keepDictionaryIndex),
+                                   USERLAYERRANKBIAS,QString(),true);
+    }
+    QList<QString> values(const QString &pinyin) const
+    {
+        return layeredDictionary.values(pinyin);
+    }
+    QList<QString> keys() const
+    {
+        return layeredDictionary.keys();
+    }
+
+private:
+    //共享指针的空删除器，用户词典随本对象析构
+    static void keepDictionaryIndex(const DictionaryIndex *)
+    {
+    }
+
+    UserDictionary userDictionary;
+    LayeredDictionary layeredDictionary;
+};
+
+//参与比较的索引
+struct Engine
+{
+    QString name;
+    QSharedPointer<const DictionaryIndex> index;
+    qint64 loadNsecs;
+    qint64 memoryBytes;//-1表示不适用
+    QString memoryNote;
+    //比较结果
+    int identicalCount;
+    int supersetCount;
+    int reorderedCount;
+    int missingCount;
+    int extraKeyCount;//基准没有结果而新索引有结果的拼音
+    qint64 queryNsecs;
+};
+
+static QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+static QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+static void printUsage()
+{
+    err()<<"usage: dictdiff [-z dict.pyz] [-r randomPrefixes] [--seed n] [-b blockSize] [ChinesePinyin]\n";
+    err().flush();
+}
+/*
+ *@brief:   读拼音字典，将汉字与对应拼音存放到hash表中
+ *@author:  缪庆瑞
+ *@date:    2020.05.09
+ */
+bool LegacyDictionary::readDictionary(const QString &filePath)
+{
+    QFile pinyinFile(filePath);
+    if(!pinyinFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QRegExp regExp("[a-z']+");//正则表达式，匹配1个或多个由a-z及 ' 组成的字母串，默认区分大小写
+    QString lineText;//存放读取的一行数据 汉字-拼音
+    QString linePinyin;//存放正则表达式匹配的拼音
+    QString lineChinese;//存放拼音对应的汉字
+    int pinyinPosition;//每一行匹配拼音的位置
+    while(!pinyinFile.atEnd())//while循环读取拼音文件，直到读完
+    {
+        lineText = QString(QString::fromUtf8(pinyinFile.readLine()));
+        pinyinPosition=regExp.indexIn(lineText,0);//获取读取行的文本中匹配正则表达式的位置
+        linePinyin = regExp.cap(0);//regExp.cap(0)表示完整正则表达式的匹配
+        lineChinese = lineText.left(pinyinPosition);//lineText.left(n)可以获取左边那个字符即对应的汉字
+        if(linePinyin.contains("'"))//如果有单引号表示是词组，则进行拆分词组
+        {
+            splitPhrase(linePinyin,lineChinese);
+        }
+        else//单个汉字
+        {
+            chinesePinyin.insert(linePinyin,lineChinese);//往哈希表插入键值对
+        }
+    }
+    return true;
+}
+/*
+ *@brief:   拆分拼音词组，拼音字典文件词组用'分割，如"ai'qing"该函数的功能便是去掉'，
+ * 将简拼、全拼存放到哈希表中
+ *@author:  缪庆瑞
+ *@date:    2017.2.7
+ *@param:   phrase:要处理的拼音词组
+ *@param:   chinese:拼音对应的汉字
+ */
+void LegacyDictionary::splitPhrase(QString phrase,QString chinese)
+{
+    int count = phrase.count("'");
+    if(count==1)//两个汉字
+    {
+        int index=phrase.indexOf("'");
+        QString pinyin1=phrase.left(1);//两字首字母简拼 例aq
+        pinyin1.append(phrase.at(index+1));
+        chinesePinyin.insert(pinyin1,chinese);
+        QString pinyin2=phrase.left(index);//全拼+首字母 aiq
+        pinyin2.append(phrase.at(index+1));
+        if(pinyin2!=pinyin1)//避免同一词组键值对插入哈希表多次 例如 e'xi
+        {
+            chinesePinyin.insert(pinyin2,chinese);
+        }
+        QString pinyin3=phrase.remove("'");//全拼 aiqing
+        if(pinyin3!=pinyin2)
+        {
+             chinesePinyin.insert(pinyin3,chinese);
+        }
+    }
+    else if(count==2)//三个汉字
+    {
+        int index1=phrase.indexOf("'");
+        int index2=phrase.indexOf("'",index1+1);
+        QString pinyin1=phrase.left(1);//三字首字母简拼
+        pinyin1.append(phrase.at(index1+1));
+        pinyin1.append(phrase.at(index2+1));
+        chinesePinyin.insert(pinyin1,chinese);
+        QString pinyin2=phrase.left(index1);//全拼+首字母+首字母
+        pinyin2.append(phrase.at(index1+1));
+        pinyin2.append(phrase.at(index2+1));
+        if(pinyin2!=pinyin1)//避免同一词组键值对插入哈希表多次 例如 e'xi
+        {
+            chinesePinyin.insert(pinyin2,chinese);
+        }
+        QString pinyin3=phrase.left(index2);//全拼+全拼+首字母
+        pinyin3.append(phrase.at(index2+1));
+        pinyin3.remove("'");
+        if(pinyin3!=pinyin2)//避免同一词组键值对插入哈希表多次 例如 e'xi
+        {
+            chinesePinyin.insert(pinyin3,chinese);
+        }
+        QString pinyin4=phrase.remove("'");//全拼
+        if(pinyin4!=pinyin3)//避免同一词组键值对插入哈希表多次 例如 e'xi
+        {
+            chinesePinyin.insert(pinyin4,chinese);
+        }
+    }
+    else if(count==3)//四个汉字
+    {
+        int index1=phrase.indexOf("'");
+        int index2=phrase.indexOf("'",index1+1);
+        int index3=phrase.indexOf("'",index2+1);
+        QString pinyin1=phrase.left(1);//四字首字母简拼
+        pinyin1.append(phrase.at(index1+1));
+        pinyin1.append(phrase.at(index2+1));
+        pinyin1.append(phrase.at(index3+1));
+        chinesePinyin.insert(pinyin1,chinese);
+        QString pinyin2=phrase.left(index1);//全拼+首字母+首字母+首字母
+        pinyin2.append(phrase.at(index1+1));
+        pinyin2.append(phrase.at(index2+1));
+        pinyin2.append(phrase.at(index3+1));
+        if(pinyin2!=pinyin1)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        {
+            chinesePinyin.insert(pinyin2,chinese);
+        }
+        QString pinyin3=phrase.left(index2);//全拼+全拼+首字母+首字母
+        pinyin3.append(phrase.at(index2+1));
+        pinyin3.append(phrase.at(index3+1));
+        pinyin3.remove("'");
+        if(pinyin3!=pinyin2)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        {
+            chinesePinyin.insert(pinyin3,chinese);
+        }
+        QString pinyin4=phrase.left(index3);//全拼+全拼+全拼+首字母
+        pinyin4.append(phrase.at(index3+1));
+        pinyin4.remove("'");
+        if(pinyin4!=pinyin3)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        {
+            chinesePinyin.insert(pinyin4,chinese);
+        }
+        QString pinyin5=phrase.remove("'");//全拼
+        if(pinyin5!=pinyin4)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        {
+            chinesePinyin.insert(pinyin5,chinese);
+        }
+    }
+}
+/*
+ *@brief:   根据输入的拼音匹配中文，哈希表一键多值时后插入的先获取，常用字在列表后面
+ *@author:  缪庆瑞
+ *@date:    2017.1.1
+ */
+QList<QString> LegacyDictionary::matchChinese(const QString &pinyin) const
+{
+    return chinesePinyin.values(pinyin);
+}
+
+QList<QString> LegacyDictionary::keys() const
+{
+    return chinesePinyin.uniqueKeys();
+}
+/*
+ *@brief:   QString占用内存的估算，数据头加UTF-16字符及结束符，按8字节对齐
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static qint64 stringBytes(const QString &text)
+{
+    return (STRINGHEADERBYTES+2*(text.length()+1)+7)/8*8;
+}
+/*
+ *@brief:   估算拼音-汉字哈希表的内存占用，与dictc的估算方法一致
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static qint64 hashBytes(const QList<QString> &keyList,const DictionaryIndex *index,const LegacyDictionary *legacy)
+{
+    qint64 bytes = 0;
+    for(int i=0;i<keyList.size();i++)
+    {
+        QList<QString> valueList = index?index->values(keyList.at(i)):legacy->matchChinese(keyList.at(i));
+        for(int j=0;j<valueList.size();j++)
+        {
+            bytes += HASHNODEBYTES+stringBytes(keyList.at(i))+stringBytes(valueList.at(j))+sizeof(void *);
+        }
+    }
+    return bytes;
+}
+/*
+ *@brief:   生成随机前缀，一半为随机拼音的截断(接近真实输入过程)，一半为随机字母串(覆盖不存在的拼音)
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static QStringList randomPrefixes(const QStringList &keyList,int count)
+{
+    QStringList prefixList;
+    for(int i=0;i<count;i++)
+    {
+        if(i%2 == 0 && !keyList.isEmpty())
+        {
+            const QString &key = keyList.at(qrand()%keyList.size());
+            prefixList.append(key.left(1+qrand()%key.length()));
+        }
+        else
+        {
+            QString letters;
+            int length = 1+qrand()%MAXRANDOMLETTERS;
+            for(int j=0;j<length;j++)
+            {
+                letters.append(QChar('a'+qrand()%26));
+            }
+            prefixList.append(letters);
+        }
+    }
+    return prefixList;
+}
+/*
+ *@brief:   判断基准候选词是否为新候选词的子序列，即新候选词只是在基准之外多出候选词，
+ * 基准候选词的相对顺序不变
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static bool isSubsequence(const QList<QString> &legacyList,const QList<QString> &newList)
+{
+    int j = 0;
+    for(int i=0;i<newList.size() && j<legacyList.size();i++)
+    {
+        if(newList.at(i) == legacyList.at(j))
+        {
+            j++;
+        }
+    }
+    return j == legacyList.size();
+}
+/*
+ *@brief:   候选词显示时从列表末尾反向读取，报告时按显示顺序输出
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static QString displayOrder(const QList<QString> &valueList)
+{
+    QStringList displayList;
+    for(int i=valueList.size()-1;i>=0;i--)
+    {
+        displayList.append(valueList.at(i));
+    }
+    return displayList.join(" ");
+}
+/*
+ *@brief:   比较一个拼音在基准和新索引中的候选词并计数，差异逐条报告
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static void compareKey(const QString &pinyin,const QList<QString> &legacyList,Engine &engine)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QList<QString> newList = engine.index->values(pinyin);
+    engine.queryNsecs += timer.nsecsElapsed();
+    if(newList == legacyList)
+    {
+        engine.identicalCount++;
+        return;
+    }
+    if(legacyList.isEmpty())
+    {
+        engine.extraKeyCount++;
+    }
+    if(isSubsequence(legacyList,newList))//列表整体反转后子序列关系不变，不必按显示顺序比较
+    {
+        engine.supersetCount++;
+        return;
+    }
+    QSet<QString> newSet = QSet<QString>::fromList(newList);
+    bool isMissing = false;
+    for(int i=0;i<legacyList.size() && !isMissing;i++)
+    {
+        isMissing = !newSet.contains(legacyList.at(i));
+    }
+    if(isMissing)
+    {
+        engine.missingCount++;
+    }
+    else
+    {
+        engine.reorderedCount++;
+    }
+    if(engine.missingCount+engine.reorderedCount <= MAXREPORTEDDIFFS)
+    {
+        err()<<engine.name<<": "<<(isMissing?"missing":"reordered")<<" "<<pinyin<<"\n"
+             <<"  legacy: "<<displayOrder(legacyList)<<"\n"
+             <<"  "<<engine.name<<": "<<displayOrder(newList)<<"\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc,argv);
+    out().setCodec("UTF-8");
+    err().setCodec("UTF-8");
+    QStringList arguments = app.arguments();
+    QString dictPath = DEFAULTDICTPATH;
+    QString compressedPath;
+    int randomCount = DEFAULTRANDOMNUM;
+    uint seed = 1;
+    int blockSize = DEFAULTBLOCKSIZE;
+    for(int i=1;i<arguments.size();i++)
+    {
+        QString argument = arguments.at(i);
+        bool hasValue = (i+1<arguments.size());
+        if(argument == "-z" && hasValue)
+        {
+            compressedPath = arguments.at(++i);
+        }
+        else if(argument == "-r" && hasValue)
+        {
+            randomCount = qMax(0,arguments.at(++i).toInt());
+        }
+        else if(argument == "--seed" && hasValue)
+        {
+            seed = arguments.at(++i).toUInt();
+        }
+        else if(argument == "-b" && hasValue)
+        {
+            blockSize = qMax(256,arguments.at(++i).toInt());
+        }
+        else if(argument.startsWith("-"))
+        {
+            printUsage();
+            return 2;
+        }
+        else
+        {
+            dictPath = argument;
+        }
+    }
+    /*****************构建基准及各个索引*****************/
+    QElapsedTimer timer;
+    LegacyDictionary legacy;
+    timer.start();
+    if(!legacy.readDictionary(dictPath))
+    {
+        err()<<dictPath<<": cannot open\n";
+        return 1;
+    }
+    qint64 legacyNsecs = timer.nsecsElapsed();
+    QList<QString> legacyKeys = legacy.keys();
+    qint64 legacyBytes = hashBytes(legacyKeys,0,&legacy);
+
+    QList<Engine> engines;
+    Engine textEngine;
+    PinyinDictionary *textDictionary = new PinyinDictionary();
+    timer.restart();
+    textDictionary->load(dictPath);
+    textEngine.name = "text";
+    textEngine.loadNsecs = timer.nsecsElapsed();
+    textEngine.index = QSharedPointer<const DictionaryIndex>(textDictionary);
+    textEngine.memoryBytes = hashBytes(textDictionary->keys(),textDictionary,0);
+    textEngine.memoryNote = "hash table + sentence decoder";
+    engines.append(textEngine);
+
+    QTemporaryFile generatedFile;
+    if(!generatedFile.open())
+    {
+        err()<<"cannot create temporary file\n";
+        return 1;
+    }
+    generatedFile.close();
+    if(!CompressedDictionary::write(generatedFile.fileName(),*textDictionary,blockSize))
+    {
+        err()<<generatedFile.fileName()<<": cannot write\n";
+        return 1;
+    }
+    QStringList compressedPaths(generatedFile.fileName());
+    QStringList compressedNames("compressed");
+    if(!compressedPath.isEmpty())
+    {
+        compressedPaths.append(compressedPath);
+        compressedNames.append("pyz");
+    }
+    for(int i=0;i<compressedPaths.size();i++)
+    {
+        Engine compressedEngine;
+        CompressedDictionary *compressedDictionary = new CompressedDictionary();
+        timer.restart();
+        if(!compressedDictionary->open(compressedPaths.at(i)))
+        {
+            err()<<compressedPaths.at(i)<<": cannot open\n";
+            delete compressedDictionary;
+            return 1;
+        }
+        compressedEngine.name = compressedNames.at(i);
+        compressedEngine.loadNsecs = timer.nsecsElapsed();
+        compressedEngine.index = QSharedPointer<const DictionaryIndex>(compressedDictionary);
+        compressedEngine.memoryBytes = -1;//页面缓存共用，比较完成后统计
+        compressedEngine.memoryNote = QString("%1 KB file, shared page cache")
+                .arg(QFileInfo(compressedPaths.at(i)).size()/1024);
+        engines.append(compressedEngine);
+    }
+    //键盘实际的查询路径 分层字典中为压缩字典层和空的用户词典层
+    Engine layeredEngine;
+    layeredEngine.name = "layered";
+    layeredEngine.loadNsecs = engines.at(1).loadNsecs;
+    layeredEngine.index = QSharedPointer<const DictionaryIndex>(new LayeredIndex(engines.at(1).index));
+    layeredEngine.memoryBytes = -1;
+    layeredEngine.memoryNote = "same as compressed";
+    engines.append(layeredEngine);
+    /*****************生成查询的拼音：所有键(基准及新索引的并集)及随机前缀*****************/
+    QSet<QString> keySet = QSet<QString>::fromList(legacyKeys);
+    for(int i=0;i<engines.size();i++)
+    {
+        keySet.unite(QSet<QString>::fromList(engines.at(i).index->keys()));
+    }
+    QStringList keyList = keySet.toList();
+    std::sort(keyList.begin(),keyList.end());//排序保证随机前缀可以按种子复现
+    qsrand(seed);
+    QStringList prefixList = randomPrefixes(keyList,randomCount);
+    QStringList queryList = keyList+prefixList;
+    /*****************逐个比较*****************/
+    CompressedDictionary::resetStatistics();
+    for(int i=0;i<engines.size();i++)
+    {
+        engines[i].identicalCount = 0;
+        engines[i].supersetCount = 0;
+        engines[i].reorderedCount = 0;
+        engines[i].missingCount = 0;
+        engines[i].extraKeyCount = 0;
+        engines[i].queryNsecs = 0;
+    }
+    qint64 legacyQueryNsecs = 0;
+    for(int i=0;i<queryList.size();i++)
+    {
+        timer.restart();
+        QList<QString> legacyList = legacy.matchChinese(queryList.at(i));
+        legacyQueryNsecs += timer.nsecsElapsed();
+        for(int j=0;j<engines.size();j++)
+        {
+            compareKey(queryList.at(i),legacyList,engines[j]);
+        }
+    }
+    CompressedDictionary::Statistics pageStats = CompressedDictionary::statistics();
+    /*****************报告*****************/
+    out()<<"dictionary:        "<<dictPath<<"\n";
+    out()<<"queries:           "<<queryList.size()<<" ("<<keyList.size()<<" keys, "<<prefixList.size()
+        <<" random prefixes, seed "<<seed<<")\n\n";
+    out()<<QString("%1%2%3%4%5%6%7%8  %9\n").arg("engine",-12).arg("load ms",10).arg("query us",10)
+           .arg("memory KB",11).arg("identical",11).arg("superset",10).arg("reordered",11).arg("missing",9)
+           .arg("memory");
+    int queryCount = qMax(1,queryList.size());
+    out()<<QString("%1%2%3%4%5%6%7%8  %9\n").arg("legacy",-12).arg(legacyNsecs/1e6,10,'f',1)
+           .arg(legacyQueryNsecs/1e3/queryCount,10,'f',2).arg(legacyBytes/1024,11)
+           .arg("-",11).arg("-",10).arg("-",11).arg("-",9).arg("QMultiHash");
+    bool isEquivalent = true;
+    for(int i=0;i<engines.size();i++)
+    {
+        const Engine &engine = engines.at(i);
+        QString memory = (engine.memoryBytes<0)?QString("-"):QString::number(engine.memoryBytes/1024);
+        out()<<QString("%1%2%3%4%5%6%7%8  %9\n").arg(engine.name,-12).arg(engine.loadNsecs/1e6,10,'f',1)
+               .arg(engine.queryNsecs/1e3/queryCount,10,'f',2).arg(memory,11)
+               .arg(engine.identicalCount,11).arg(engine.supersetCount,10).arg(engine.reorderedCount,11)
+               .arg(engine.missingCount,9).arg(engine.memoryNote);
+        if(engine.extraKeyCount > 0)
+        {
+            out()<<"  "<<engine.name<<": "<<engine.extraKeyCount<<" queries only answered by the new index\n";
+        }
+        isEquivalent = isEquivalent && engine.reorderedCount==0 && engine.missingCount==0;
+    }
+    out()<<"\npage cache:        "<<pageStats.residentBytes/1024<<" KB resident of "
+        <<pageStats.memoryBudget/1024<<" KB budget, "<<pageStats.pageInLatency.count()<<" page-ins\n";
+    out()<<"result:            "<<(isEquivalent?"equivalent":"NOT equivalent")<<"\n";
+    out().flush();
+    return isEquivalent?0:1;
+}
@@ -0,0 +1,36 @@
+#-------------------------------------------------
+#
+# 字典等价性检查工具，比较新字典索引与原QMultiHash实现的候选词及加载时间、内存
+# 例: dictdiff -z ChinesePinyin.pyz ChinesePinyin
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = dictdiff
+CONFIG += console
+CONFIG -= app_bundle
+OBJECTS_DIR = .obj/$$TARGET  #与键盘共用的源文件编译选项不同，中间文件分开存放
+MOC_DIR = .moc/$$TARGET
+TEMPLATE = app
+
+
+SOURCES += dictdiff.cpp \
+    pinyinsyllable.cpp \
+    sentencedecoder.cpp \
+    pinyindictionary.cpp \
+    compresseddictionary.cpp \
+    latencyhistogram.cpp \
+    layereddictionary.cpp \
+    userdictionary.cpp
+
+HEADERS  += \
+    pinyinsyllable.h \
+    sentencedecoder.h \
+    dictionaryindex.h \
+    pinyindictionary.h \
+    compresseddictionary.h \
+    latencyhistogram.h \
+    layereddictionary.h \
+    userdictionary.h
@@ -0,0 +1,74 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  字典索引接口，系统字典、领域字典、用户字典等各层字典都实现该接口，
+ * 由分层字典统一查询。除用户字典等可修改的层外，字典构建完成后只读，查询接口可以被多个键盘、
+ * 多个线程同时调用。文本字典的查询不加锁；压缩字典的页面缓存为所有字典共用，查询时需要
+ * 短暂持有缓存的互斥锁
+ */
+#ifndef DICTIONARYINDEX_H
+#define DICTIONARYINDEX_H
+
+#include <QString>
+#include <QList>
+#include <QtGlobal>
+
+class SentenceDecoder;
+
+/*遍历字典所有拼音的访问者，用于在后台构建笔画等派生索引*/
+class DictionaryVisitor
+{
+public:
+    virtual ~DictionaryVisitor() {}
+    virtual void visit(const QString &pinyin,const QList<QString> &valueList) = 0;//每个拼音调用一次
+};
+
+class DictionaryIndex
+{
+public:
+    //字典规模及加载耗时统计，内存为按数据结构估算的值
+    struct LoadStatistics
+    {
+        int entryCount;//字典文件中的字词条数
+        int phraseCount;//其中的词组条数
+        int keyCount;//不重复的拼音个数
+        int valueCount;//拼音-字词键值对个数，一个词组拆分为简拼、全拼等多个键
+        qint64 indexBytes;//索引结构占用的内存(字节)
+        qint64 stringBytes;//拼音及字词文本占用的内存(字节)
+        qint64 readNsecs;//读文件及解析耗时(ns)
+        qint64 indexNsecs;//构建索引耗时(ns)
+        qint64 decoderNsecs;//构建整句解码词表耗时(ns)
+    };
+
+    virtual ~DictionaryIndex() {}
+
+    //获取拼音对应的汉字列表，与哈希表一键多值的顺序一致，常用词在列表后面
+    virtual QList<QString> values(const QString &pinyin) const = 0;
+    //所有拼音(不重复)
+    virtual QList<QString> keys() const = 0;
+    //整句解码词表，不支持整句解码的字典返回空
+    virtual const SentenceDecoder *sentenceDecoder() const { return 0; }
+    //遍历所有拼音及其汉字列表，分块存储的字典应直接读取各块，不经过查询缓存
+    virtual void visitEntries(DictionaryVisitor &visitor) const
+    {
+        QList<QString> keyList = keys();
+        for(int i=0;i<keyList.size();i++)
+        {
+            visitor.visit(keyList.at(i),values(keyList.at(i)));
+        }
+    }
+    //字典规模及加载耗时，不统计的字典各项为0
+    virtual LoadStatistics loadStatistics() const
+    {
+        LoadStatistics stats = {0,0,0,0,0,0,0,0,0};
+        return stats;
+    }
+};
+
+#endif // DICTIONARYINDEX_H
@@ -0,0 +1,327 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  英文单词补全，由词频表构建带词频的字典树，按前缀取词频最高的若干单词；
+ * 同时由二元词频给出下一个单词的联想
+ */
+#include "englishcompleter.h"
+#include <QFile>
+#include <QRegExp>
+#include <QElapsedTimer>
+#include <QVarLengthArray>
+#include <queue>
+#include <algorithm>
+
+#define DEFAULTFREQUENCY    1   //词频表中未写词频的单词的词频
+
+/*最优优先搜索的队列项*/
+struct CompletionItem
+{
+    quint32 score;//节点为子树最大词频，单词为其词频
+    int node;
+    QString text;//节点对应的前缀或单词
+    bool isWord;
+    bool operator<(const CompletionItem &other) const
+    {
+        return score < other.score;
+    }
+};
+
+/*按词频由高到低排序的比较函数*/
+static bool greaterChildFrequency(const QPair<quint32,int> &left,const QPair<quint32,int> &right)
+{
+    return left.first > right.first;
+}
+
+static bool greaterNextFrequency(const QPair<QString,quint32> &left,const QPair<QString,quint32> &right)
+{
+    return left.second > right.second;
+}
+
+EnglishCompleter::EnglishCompleter()
+{
+    clear();
+    resetStatistics();
+}
+/*
+ *@brief:   读词频表，每行为"单词 词频"或"单词1 单词2 词频"(二元词频)，词频省略时为1，
+ * #开头的行为注释。单词不区分大小写
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:词频表文件路径
+ *@return:  文件是否打开成功
+ */
+bool EnglishCompleter::load(const QString &filePath)
+{
+    clear();
+    QFile wordFile(filePath);
+    if(!wordFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    while(!wordFile.atEnd())
+    {
+        QString lineText = QString::fromUtf8(wordFile.readLine()).trimmed().toLower();
+        if(lineText.isEmpty() || lineText.startsWith('#'))
+        {
+            continue;
+        }
+        QStringList fieldList = lineText.split(QRegExp("\\s+"),QString::SkipEmptyParts);
+        quint32 frequency = DEFAULTFREQUENCY;
+        bool ok = false;
+        quint32 value = fieldList.last().toUInt(&ok);
+        if(ok && fieldList.size() > 1)
+        {
+            frequency = qMax(value,quint32(1));
+            fieldList.removeLast();
+        }
+        if(fieldList.size() == 1)
+        {
+            insertWord(fieldList.first(),frequency);
+        }
+        else if(fieldList.size() == 2)
+        {
+            bigrams[fieldList.at(0)].append(qMakePair(fieldList.at(1),frequency));
+        }
+    }
+    finishNode(0);
+    //二元词频按词频由高到低排序
+    QHash<QString,QList<QPair<QString,quint32> > >::iterator it = bigrams.begin();
+    for(;it!=bigrams.end();++it)
+    {
+        std::stable_sort(it.value().begin(),it.value().end(),greaterNextFrequency);
+    }
+    return true;
+}
+
+void EnglishCompleter::clear()
+{
+    nodes.clear();
+    TrieNode root;
+    root.firstChild = -1;
+    root.nextSibling = -1;
+    root.frequency = 0;
+    root.maxFrequency = 0;
+    nodes.append(root);
+    words = 0;
+    bigrams.clear();
+}
+
+bool EnglishCompleter::isEmpty() const
+{
+    return words == 0 && bigrams.isEmpty();
+}
+
+int EnglishCompleter::wordCount() const
+{
+    return words;
+}
+/*
+ *@brief:   前缀补全。子节点按子树最大词频排序，从前缀节点开始做最优优先搜索：队列中的节点
+ * 以子树最大词频为上界，弹出节点时才加入它的下一个兄弟节点和第一个子节点，所以只访问与结果
+ * 个数成正比的少量节点，与词表大小无关。结果的大小写跟随输入的前缀
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   prefix:已输入的前缀
+ *@param:   maxResults:最多返回的单词个数
+ *@return:  单词列表，按词频由高到低，不含前缀本身
+ */
+QStringList EnglishCompleter::complete(const QString &prefix, int maxResults)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QStringList result;
+    QString lowerPrefix = prefix.toLower();
+    int prefixNode = findNode(lowerPrefix);
+    if(prefixNode < 0)
+    {
+        recordQuery(timer.nsecsElapsed());
+        return result;
+    }
+    std::priority_queue<CompletionItem> queue;
+    CompletionItem startItem = {nodes.at(prefixNode).maxFrequency,prefixNode,lowerPrefix,false};
+    queue.push(startItem);
+    while(!queue.empty() && result.size()<maxResults)
+    {
+        CompletionItem item = queue.top();
+        queue.pop();
+        if(item.isWord)
+        {
+            if(item.text != lowerPrefix)
+            {
+                result.append(item.text);
+            }
+            continue;
+        }
+        const TrieNode &node = nodes.at(item.node);
+        if(item.node != prefixNode && node.nextSibling >= 0)//兄弟节点的上界不高于本节点
+        {
+            QString siblingText = item.text;
+            siblingText[siblingText.length()-1] = nodes.at(node.nextSibling).letter;
+            CompletionItem siblingItem = {nodes.at(node.nextSibling).maxFrequency,node.nextSibling,siblingText,false};
+            queue.push(siblingItem);
+        }
+        if(node.frequency > 0)
+        {
+            CompletionItem wordItem = {node.frequency,item.node,item.text,true};
+            queue.push(wordItem);
+        }
+        if(node.firstChild >= 0)
+        {
+            CompletionItem childItem = {nodes.at(node.firstChild).maxFrequency,node.firstChild,
+                                        item.text+nodes.at(node.firstChild).letter,false};
+            queue.push(childItem);
+        }
+    }
+    //大小写跟随前缀 首字母大写或全部大写
+    bool isFirstUpper = !prefix.isEmpty() && prefix.at(0).isUpper();
+    bool isAllUpper = prefix.length()>1 && prefix==prefix.toUpper();
+    for(int i=0;i<result.size();i++)
+    {
+        if(isAllUpper)
+        {
+            result[i] = result.at(i).toUpper();
+        }
+        else if(isFirstUpper)
+        {
+            result[i][0] = result.at(i).at(0).toUpper();
+        }
+    }
+    recordQuery(timer.nsecsElapsed());
+    return result;
+}
+/*
+ *@brief:   下一个单词联想
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   word:上一个单词
+ *@param:   maxResults:最多返回的单词个数
+ *@return:  单词列表，按词频由高到低
+ */
+QStringList EnglishCompleter::nextWords(const QString &word, int maxResults)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QStringList result;
+    QHash<QString,QList<QPair<QString,quint32> > >::const_iterator it = bigrams.constFind(word.toLower());
+    if(it != bigrams.constEnd())
+    {
+        for(int i=0;i<it.value().size() && i<maxResults;i++)
+        {
+            result.append(it.value().at(i).first);
+        }
+    }
+    recordQuery(timer.nsecsElapsed());
+    return result;
+}
+
+EnglishCompleter::Statistics EnglishCompleter::statistics() const
+{
+    return stats;
+}
+
+void EnglishCompleter::resetStatistics()
+{
+    stats.latency.clear();
+}
+/*
+ *@brief:   向字典树插入单词，重复的单词词频累加
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   word:单词(小写)
+ *@param:   frequency:词频
+ */
+void EnglishCompleter::insertWord(const QString &word, quint32 frequency)
+{
+    int node = 0;
+    for(int i=0;i<word.length();i++)
+    {
+        int child = nodes.at(node).firstChild;
+        while(child >= 0 && nodes.at(child).letter != word.at(i))
+        {
+            child = nodes.at(child).nextSibling;
+        }
+        if(child < 0)
+        {
+            TrieNode newNode;
+            newNode.firstChild = -1;
+            newNode.nextSibling = nodes.at(node).firstChild;
+            newNode.letter = word.at(i);
+            newNode.frequency = 0;
+            newNode.maxFrequency = 0;
+            child = nodes.size();
+            nodes.append(newNode);
+            nodes[node].firstChild = child;
+        }
+        node = child;
+    }
+    if(node == 0)
+    {
+        return;
+    }
+    if(nodes.at(node).frequency == 0)
+    {
+        words++;
+    }
+    nodes[node].frequency += frequency;
+}
+/*
+ *@brief:   计算子树最大词频，并将子节点按子树最大词频由高到低重新链接
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   node:节点
+ */
+void EnglishCompleter::finishNode(int node)
+{
+    QVarLengthArray<QPair<quint32,int>,32> childList;
+    for(int child=nodes.at(node).firstChild;child>=0;child=nodes.at(child).nextSibling)
+    {
+        finishNode(child);
+        childList.append(qMakePair(nodes.at(child).maxFrequency,child));
+    }
+    std::stable_sort(childList.begin(),childList.end(),greaterChildFrequency);
+    int next = -1;
+    for(int i=childList.size()-1;i>=0;i--)
+    {
+        nodes[childList.at(i).second].nextSibling = next;
+        next = childList.at(i).second;
+    }
+    nodes[node].firstChild = next;
+    nodes[node].maxFrequency = nodes.at(node).frequency;
+    if(next >= 0)
+    {
+        nodes[node].maxFrequency = qMax(nodes.at(node).maxFrequency,nodes.at(next).maxFrequency);
+    }
+}
+/*
+ *@brief:   查找前缀对应的节点
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   prefix:前缀(小写)
+ *@return:  节点序号，不存在时返回-1
+ */
+int EnglishCompleter::findNode(const QString &prefix) const
+{
+    int node = 0;
+    for(int i=0;i<prefix.length() && node>=0;i++)
+    {
+        int child = nodes.at(node).firstChild;
+        while(child >= 0 && nodes.at(child).letter != prefix.at(i))
+        {
+            child = nodes.at(child).nextSibling;
+        }
+        node = child;
+    }
+    return node;
+}
+
+void EnglishCompleter::recordQuery(qint64 nsecs)
+{
+    stats.latency.add(nsecs);
+}
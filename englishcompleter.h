@@ -0,0 +1,66 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  英文单词补全，由词频表构建带词频的字典树，按前缀取词频最高的若干单词；
+ * 同时由二元词频给出下一个单词的联想
+ */
+#ifndef ENGLISHCOMPLETER_H
+#define ENGLISHCOMPLETER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include "latencyhistogram.h"
+
+class EnglishCompleter
+{
+public:
+    //查询开销统计
+    struct Statistics
+    {
+        LatencyHistogram latency;//每次补全及联想的耗时分布
+    };
+
+    EnglishCompleter();
+
+    bool load(const QString &filePath);//读词频表
+    void clear();
+    bool isEmpty() const;
+    int wordCount() const;//单词个数
+    QStringList complete(const QString &prefix,int maxResults);//前缀补全，按词频由高到低
+    QStringList nextWords(const QString &word,int maxResults);//下一个单词联想，按词频由高到低
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    //字典树节点 子节点用兄弟链表存放，并按子树最大词频由高到低排列
+    struct TrieNode
+    {
+        int firstChild;
+        int nextSibling;
+        QChar letter;
+        quint32 frequency;//以该节点结尾的单词词频，0表示不是单词
+        quint32 maxFrequency;//子树(含本节点)中最大的单词词频
+    };
+
+    void insertWord(const QString &word,quint32 frequency);
+    void finishNode(int node);//计算子树最大词频并排序子节点
+    int findNode(const QString &prefix) const;//前缀对应的节点
+    void recordQuery(qint64 nsecs);
+
+    QVector<TrieNode> nodes;//nodes[0]为根节点
+    int words;
+    QHash<QString,QList<QPair<QString,quint32> > > bigrams;//单词-(下一个单词,词频)，按词频由高到低
+    Statistics stats;
+};
+
+#endif // ENGLISHCOMPLETER_H
@@ -0,0 +1,217 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  模糊音，在查询时将输入的拼音按模糊音规则展开为多个候选拼音，不增加字典的键值对
+ */
+#include "fuzzypinyin.h"
+#include "pinyinsyllable.h"
+#include <algorithm>
+
+#define DEFAULTMAXVARIANTS 16 //默认单次查询最多展开的拼音个数(含输入本身)
+
+FuzzyPinyin::FuzzyPinyin()
+    :fuzzyMask(0),maxVariantNum(DEFAULTMAXVARIANTS)
+{
+    resetStatistics();
+}
+/*
+ *@brief:   设置模糊音规则
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   mask:FuzzyFlag按位组合，0表示关闭模糊音
+ */
+void FuzzyPinyin::setMask(int mask)
+{
+    fuzzyMask = mask&FuzzyAll;
+}
+
+int FuzzyPinyin::mask() const
+{
+    return fuzzyMask;
+}
+/*
+ *@brief:   设置单次查询最多展开的拼音个数，以此限定每次按键额外的查表次数
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   maxVariants:最多展开的拼音个数(含输入本身)
+ */
+void FuzzyPinyin::setMaxVariants(int maxVariants)
+{
+    maxVariantNum = qMax(1,maxVariants);
+}
+
+int FuzzyPinyin::maxVariants() const
+{
+    return maxVariantNum;
+}
+
+static bool lessChanges(const QPair<QString,int> &left,const QPair<QString,int> &right)
+{
+    return left.second < right.second;
+}
+/*
+ *@brief:   展开输入拼音。先将拼音切分为音节，对每个音节按模糊音规则得到替换音节，再逐音节组合。
+ * 每组合一个音节就按替换次数稳定排序并截断到最大个数，所以展开的开销与音节数成线性关系，
+ * 且保留下来的总是与输入差异最小的拼音。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:输入的拼音
+ *@return:  展开后的拼音列表，第一个为输入本身，其余按替换次数由少到多排列
+ */
+QStringList FuzzyPinyin::expand(const QString &pinyin) const
+{
+    QStringList result;
+    result.append(pinyin);
+    if(fuzzyMask == 0 || pinyin.isEmpty())
+    {
+        return result;
+    }
+    QList<QPair<QString,int> > partialList;
+    partialList.append(qMakePair(QString(),0));
+    QStringList syllableList = PinyinSyllable::split(pinyin);
+    for(int i=0;i<syllableList.size();i++)
+    {
+        QList<QPair<QString,int> > variantList = syllableVariants(syllableList.at(i));
+        QList<QPair<QString,int> > combinedList;
+        for(int j=0;j<partialList.size();j++)
+        {
+            for(int k=0;k<variantList.size();k++)
+            {
+                combinedList.append(qMakePair(partialList.at(j).first+variantList.at(k).first,
+                                              partialList.at(j).second+variantList.at(k).second));
+            }
+        }
+        std::stable_sort(combinedList.begin(),combinedList.end(),lessChanges);
+        partialList = combinedList.mid(0,maxVariantNum);
+    }
+    for(int i=0;i<partialList.size();i++)
+    {
+        if(partialList.at(i).second > 0 && !result.contains(partialList.at(i).first))
+        {
+            result.append(partialList.at(i).first);
+        }
+    }
+    return result;
+}
+/*
+ *@brief:   记录一次模糊查询的开销
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   variantCount:本次额外查询的拼音个数
+ *@param:   nsecs:本次模糊查询耗时(ns)
+ */
+void FuzzyPinyin::recordQuery(int variantCount, qint64 nsecs)
+{
+    stats.variantCount += variantCount;
+    stats.latency.add(nsecs);
+}
+
+FuzzyPinyin::Statistics FuzzyPinyin::statistics() const
+{
+    return stats;
+}
+
+void FuzzyPinyin::resetStatistics()
+{
+    stats.variantCount = 0;
+    stats.latency.clear();
+}
+/*
+ *@brief:   按模糊音规则计算单个音节的替换音节，只保留合法音节。切分不出的简拼或未输入完的
+ * 部分原样保留。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   syllable:音节
+ *@return:  (音节,替换次数)列表，第一个为音节本身
+ */
+QList<QPair<QString, int> > FuzzyPinyin::syllableVariants(const QString &syllable) const
+{
+    QList<QPair<QString,int> > variantList;
+    variantList.append(qMakePair(syllable,0));
+    if(!PinyinSyllable::isSyllable(syllable))
+    {
+        return variantList;
+    }
+    //声母替换
+    QStringList initialList;
+    initialList.append(syllable);
+    if(((fuzzyMask&FuzzyZZh) && syllable.startsWith('z'))
+            || ((fuzzyMask&FuzzyCCh) && syllable.startsWith('c'))
+            || ((fuzzyMask&FuzzySSh) && syllable.startsWith('s')))
+    {
+        if(syllable.length()>1 && syllable.at(1)==QChar('h'))
+        {
+            initialList.append(syllable.left(1)+syllable.mid(2));//zh->z
+        }
+        else
+        {
+            initialList.append(syllable.left(1)+"h"+syllable.mid(1));//z->zh
+        }
+    }
+    if(fuzzyMask&FuzzyNL)
+    {
+        if(syllable.startsWith('n'))
+        {
+            initialList.append("l"+syllable.mid(1));
+        }
+        else if(syllable.startsWith('l'))
+        {
+            initialList.append("n"+syllable.mid(1));
+        }
+    }
+    //韵母替换
+    for(int i=0;i<initialList.size();i++)
+    {
+        QStringList finalList;
+        finalList.append(initialList.at(i));
+        const QString &text = initialList.at(i);
+        if(fuzzyMask&FuzzyAnAng)
+        {
+            if(text.endsWith("ang"))
+            {
+                finalList.append(text.left(text.length()-1));
+            }
+            else if(text.endsWith("an"))
+            {
+                finalList.append(text+"g");
+            }
+        }
+        if(fuzzyMask&FuzzyEnEng)
+        {
+            if(text.endsWith("eng"))
+            {
+                finalList.append(text.left(text.length()-1));
+            }
+            else if(text.endsWith("en"))
+            {
+                finalList.append(text+"g");
+            }
+        }
+        if(fuzzyMask&FuzzyInIng)
+        {
+            if(text.endsWith("ing"))
+            {
+                finalList.append(text.left(text.length()-1));
+            }
+            else if(text.endsWith("in"))
+            {
+                finalList.append(text+"g");
+            }
+        }
+        for(int j=0;j<finalList.size();j++)
+        {
+            int changes = (i>0?1:0)+(j>0?1:0);
+            if(changes > 0 && PinyinSyllable::isSyllable(finalList.at(j)))
+            {
+                variantList.append(qMakePair(finalList.at(j),changes));
+            }
+        }
+    }
+    return variantList;
+}
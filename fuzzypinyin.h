@@ -0,0 +1,63 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  模糊音，在查询时将输入的拼音按模糊音规则展开为多个候选拼音，不增加字典的键值对
+ */
+#ifndef FUZZYPINYIN_H
+#define FUZZYPINYIN_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+#include "latencyhistogram.h"
+
+class FuzzyPinyin
+{
+public:
+    //模糊音规则 可按位组合
+    enum FuzzyFlag
+    {
+        FuzzyZZh    = 0x01,//z=zh
+        FuzzyCCh    = 0x02,//c=ch
+        FuzzySSh    = 0x04,//s=sh
+        FuzzyNL     = 0x08,//n=l
+        FuzzyAnAng  = 0x10,//an=ang
+        FuzzyEnEng  = 0x20,//en=eng
+        FuzzyInIng  = 0x40,//in=ing
+        FuzzyAll    = 0x7F
+    };
+    //查询开销统计
+    struct Statistics
+    {
+        quint64 variantCount;//累计展开的模糊拼音个数
+        LatencyHistogram latency;//每次模糊查询的耗时分布
+    };
+
+    FuzzyPinyin();
+
+    void setMask(int mask);//设置模糊音规则
+    int mask() const;
+    void setMaxVariants(int maxVariants);//设置单次查询最多展开的拼音个数
+    int maxVariants() const;
+    QStringList expand(const QString &pinyin) const;//展开输入拼音
+
+    void recordQuery(int variantCount,qint64 nsecs);//记录一次模糊查询的开销
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    QList<QPair<QString,int> > syllableVariants(const QString &syllable) const;
+
+    int fuzzyMask;
+    int maxVariantNum;
+    Statistics stats;
+};
+
+#endif // FUZZYPINYIN_H
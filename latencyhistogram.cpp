@@ -0,0 +1,116 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  耗时直方图，按2的幂划分耗时区间并计数，用于统计每次按键的匹配、显示等耗时分布。
+ * 记录一次只需确定区间并累加计数，不分配内存，可以在输入过程中一直开启
+ */
+#include "latencyhistogram.h"
+
+#define FIRSTBUCKETNSECS    16000   //第一个区间的上限(ns)
+
+LatencyHistogram::LatencyHistogram()
+{
+    clear();
+}
+/*
+ *@brief:   记录一次耗时。区间i的上限为16us*2^i，从第一个区间开始倍增上限查找所在区间
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   nsecs:耗时(ns)
+ */
+void LatencyHistogram::add(qint64 nsecs)
+{
+    int bucket = 0;
+    qint64 upper = FIRSTBUCKETNSECS;
+    while(bucket < BucketCount-1 && nsecs >= upper)
+    {
+        bucket++;
+        upper *= 2;
+    }
+    buckets[bucket]++;
+    sampleCount++;
+    sumNsecs += nsecs;
+    maxValue = qMax(maxValue,nsecs);
+}
+
+void LatencyHistogram::clear()
+{
+    for(int i=0;i<BucketCount;i++)
+    {
+        buckets[i] = 0;
+    }
+    sampleCount = 0;
+    sumNsecs = 0;
+    maxValue = 0;
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return sampleCount;
+}
+
+qint64 LatencyHistogram::totalNsecs() const
+{
+    return sumNsecs;
+}
+
+qint64 LatencyHistogram::maxNsecs() const
+{
+    return maxValue;
+}
+
+quint64 LatencyHistogram::bucketCount(int bucket) const
+{
+    return (bucket>=0 && bucket<BucketCount)?buckets[bucket]:0;
+}
+/*
+ *@brief:   百分位耗时，累加各区间的次数，达到百分位时返回该区间的上限，落在最后一个区间时
+ * 返回最大耗时
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   percent:百分位(1~100)
+ */
+qint64 LatencyHistogram::percentileNsecs(int percent) const
+{
+    if(sampleCount == 0)
+    {
+        return 0;
+    }
+    quint64 target = (sampleCount*quint64(qBound(1,percent,100))+99)/100;
+    quint64 accumulated = 0;
+    for(int i=0;i<BucketCount-1;i++)
+    {
+        accumulated += buckets[i];
+        if(accumulated >= target)
+        {
+            return qMin(bucketUpperNsecs(i),maxValue);
+        }
+    }
+    return maxValue;
+}
+/*
+ *@brief:   转换为日志文本，例"n=120 avg=85us p50<=64us p99<=512us max=430us"
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+QString LatencyHistogram::toString() const
+{
+    qint64 average = sampleCount?sumNsecs/qint64(sampleCount):0;
+    return QString("n=%1 avg=%2us p50<=%3us p99<=%4us max=%5us").arg(sampleCount).arg(average/1000)
+            .arg(percentileNsecs(50)/1000).arg(percentileNsecs(99)/1000).arg(maxValue/1000);
+}
+
+qint64 LatencyHistogram::bucketUpperNsecs(int bucket)
+{
+    if(bucket < 0 || bucket >= BucketCount-1)
+    {
+        return -1;
+    }
+    return qint64(FIRSTBUCKETNSECS) << bucket;
+}
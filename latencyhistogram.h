@@ -0,0 +1,44 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  耗时直方图，按2的幂划分耗时区间并计数，用于统计每次按键的匹配、显示等耗时分布。
+ * 记录一次只需确定区间并累加计数，不分配内存，可以在输入过程中一直开启
+ */
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QString>
+#include <QtGlobal>
+
+class LatencyHistogram
+{
+public:
+    enum { BucketCount = 16 };//区间个数，第一个区间上限16us，最后一个区间无上限
+
+    LatencyHistogram();
+
+    void add(qint64 nsecs);//记录一次耗时
+    void clear();
+    quint64 count() const;//记录次数
+    qint64 totalNsecs() const;//累计耗时(ns)
+    qint64 maxNsecs() const;//单次最大耗时(ns)
+    quint64 bucketCount(int bucket) const;//区间内的次数
+    qint64 percentileNsecs(int percent) const;//百分位耗时，按所在区间的上限估算
+    QString toString() const;//次数、平均、百分位及最大耗时，用于日志
+
+    static qint64 bucketUpperNsecs(int bucket);//区间上限(ns)，最后一个区间返回-1
+
+private:
+    quint64 buckets[BucketCount];
+    quint64 sampleCount;
+    qint64 sumNsecs;
+    qint64 maxValue;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,298 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  分层字典，将系统字典、各领域字典、用户字典等多层字典合并查询。
+ * 每层字典是独立的只读索引，通过共享指针引用，可以单独加载、卸载，也可以被多个键盘共享，
+ * 增加一层小字典不需要复制大的系统字典。
+ */
+#include "layereddictionary.h"
+#include <QSet>
+#include <QVector>
+
+LayeredDictionary::LayeredDictionary()
+{
+}
+/*
+ *@brief:   添加一层字典，同名的层已存在时替换该层的索引和设置，位置不变
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   name:层名称
+ *@param:   index:字典索引
+ *@param:   rankBias:排序偏移，加到该层候选词的排名上，负值使该层的词更靠前
+ *@param:   filePath:字典文件路径，用于文件改变后重新加载
+ *@param:   isMutable:该层是否会被修改，可修改的层不在后台线程中访问
+ */
+void LayeredDictionary::setLayer(const QString &name, QSharedPointer<const DictionaryIndex> index,
+                                 int rankBias, const QString &filePath, bool isMutable)
+{
+    Layer newLayer;
+    newLayer.name = name;
+    newLayer.index = index;
+    newLayer.rankBias = rankBias;
+    newLayer.filePath = filePath;
+    newLayer.isMutable = isMutable;
+    int layerIndex = indexOf(name);
+    if(layerIndex < 0)
+    {
+        layers.append(newLayer);
+    }
+    else
+    {
+        layers[layerIndex] = newLayer;
+    }
+}
+/*
+ *@brief:   卸载一层字典，其他引用该索引的键盘不受影响
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   name:层名称
+ *@return:  该层是否存在
+ */
+bool LayeredDictionary::removeLayer(const QString &name)
+{
+    int layerIndex = indexOf(name);
+    if(layerIndex < 0)
+    {
+        return false;
+    }
+    layers.removeAt(layerIndex);
+    return true;
+}
+
+QSharedPointer<const DictionaryIndex> LayeredDictionary::layer(const QString &name) const
+{
+    int layerIndex = indexOf(name);
+    if(layerIndex < 0)
+    {
+        return QSharedPointer<const DictionaryIndex>();
+    }
+    return layers.at(layerIndex).index;
+}
+
+QStringList LayeredDictionary::layerNames() const
+{
+    QStringList nameList;
+    for(int i=0;i<layers.size();i++)
+    {
+        nameList.append(layers.at(i).name);
+    }
+    return nameList;
+}
+/*
+ *@brief:   只含只读层的副本，可以交给后台线程遍历所有层的字词
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+LayeredDictionary LayeredDictionary::readOnlyLayers() const
+{
+    LayeredDictionary dictionary;
+    for(int i=0;i<layers.size();i++)
+    {
+        if(!layers.at(i).isMutable)
+        {
+            dictionary.layers.append(layers.at(i));
+        }
+    }
+    return dictionary;
+}
+
+QStringList LayeredDictionary::layerFilePaths() const
+{
+    QStringList pathList;
+    for(int i=0;i<layers.size();i++)
+    {
+        if(!layers.at(i).filePath.isEmpty() && !pathList.contains(layers.at(i).filePath))
+        {
+            pathList.append(layers.at(i).filePath);
+        }
+    }
+    return pathList;
+}
+/*
+ *@brief:   替换所有来自该文件的字典层的索引，用于文件改变后重新加载
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@return:  替换的层数
+ */
+int LayeredDictionary::replaceFileLayers(const QString &filePath, QSharedPointer<const DictionaryIndex> index)
+{
+    int count = 0;
+    for(int i=0;i<layers.size();i++)
+    {
+        if(layers.at(i).filePath == filePath)
+        {
+            layers[i].index = index;
+            count++;
+        }
+    }
+    return count;
+}
+/*
+ *@brief:   合并查询各层字典。每层的结果已按常用程度排好序，这里做k路归并：每次从各层当前
+ * 的候选词中取(层内排名+排序偏移)最小的一个，排名相同时靠前的层优先，已取出的词不再重复。
+ * 层数很少，直接线性比较各层的当前候选词。多数拼音只有一层有结果(如用户词典没有学习记录)，
+ * 此时直接返回该层的列表，不做归并。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:拼音
+ *@return:  合并后的汉字列表，与哈希表一键多值的顺序一致，常用词在列表后面
+ */
+QList<QString> LayeredDictionary::values(const QString &pinyin) const
+{
+    QVector<QList<QString> > layerValues(layers.size());
+    QVector<int> layerPos(layers.size(),0);//各层当前候选词的排名(从最常用开始)
+    int totalCount = 0;
+    int resultLayerCount = 0;//有结果的层数
+    int resultLayer = -1;
+    for(int i=0;i<layers.size();i++)
+    {
+        layerValues[i] = layers.at(i).index->values(pinyin);
+        if(!layerValues.at(i).isEmpty())
+        {
+            totalCount += layerValues.at(i).size();
+            resultLayerCount++;
+            resultLayer = i;
+        }
+    }
+    if(resultLayerCount == 0)
+    {
+        return QList<QString>();
+    }
+    if(resultLayerCount == 1)
+    {
+        return layerValues.at(resultLayer);
+    }
+    QList<QString> mergedList;
+    QSet<QString> mergedSet;
+    mergedSet.reserve(totalCount);
+    while(true)
+    {
+        int bestLayer = -1;
+        int bestRank = 0;
+        for(int i=0;i<layers.size();i++)
+        {
+            if(layerPos.at(i) >= layerValues.at(i).size())
+            {
+                continue;
+            }
+            int rank = layerPos.at(i)+layers.at(i).rankBias;
+            if(bestLayer<0 || rank<bestRank)
+            {
+                bestLayer = i;
+                bestRank = rank;
+            }
+        }
+        if(bestLayer < 0)
+        {
+            break;
+        }
+        const QList<QString> &valueList = layerValues.at(bestLayer);
+        const QString &word = valueList.at(valueList.size()-1-layerPos.at(bestLayer));//列表反向即常用在前
+        layerPos[bestLayer]++;
+        if(!mergedSet.contains(word))
+        {
+            mergedSet.insert(word);
+            mergedList.prepend(word);//保持常用词在后的顺序
+        }
+    }
+    return mergedList;
+}
+/*
+ *@brief:   所有层的拼音(不重复)
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   includeMutable:是否包含可修改的层，在后台线程调用时应为false
+ */
+QList<QString> LayeredDictionary::keys(bool includeMutable) const
+{
+    QSet<QString> keySet;
+    for(int i=0;i<layers.size();i++)
+    {
+        if(!includeMutable && layers.at(i).isMutable)
+        {
+            continue;
+        }
+        QList<QString> keyList = layers.at(i).index->keys();
+        for(int j=0;j<keyList.size();j++)
+        {
+            keySet.insert(keyList.at(j));
+        }
+    }
+    return keySet.toList();
+}
+/*
+ *@brief:   逐层遍历所有拼音及其汉字列表，各层分别遍历，汉字列表不合并
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   visitor:访问者
+ *@param:   includeMutable:是否包含可修改的层，在后台线程调用时应为false
+ */
+void LayeredDictionary::visitEntries(DictionaryVisitor &visitor, bool includeMutable) const
+{
+    for(int i=0;i<layers.size();i++)
+    {
+        if(includeMutable || !layers.at(i).isMutable)
+        {
+            layers.at(i).index->visitEntries(visitor);
+        }
+    }
+}
+/*
+ *@brief:   各层字典加载统计之和，拼音个数为各层之和，不去除层间重复的拼音
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+DictionaryIndex::LoadStatistics LayeredDictionary::loadStatistics() const
+{
+    DictionaryIndex::LoadStatistics total = {0,0,0,0,0,0,0,0,0};
+    for(int i=0;i<layers.size();i++)
+    {
+        DictionaryIndex::LoadStatistics stats = layers.at(i).index->loadStatistics();
+        total.entryCount += stats.entryCount;
+        total.phraseCount += stats.phraseCount;
+        total.keyCount += stats.keyCount;
+        total.valueCount += stats.valueCount;
+        total.indexBytes += stats.indexBytes;
+        total.stringBytes += stats.stringBytes;
+        total.readNsecs += stats.readNsecs;
+        total.indexNsecs += stats.indexNsecs;
+        total.decoderNsecs += stats.decoderNsecs;
+    }
+    return total;
+}
+
+/*
+ *@brief:   将各层的整句解码词表加入解码器，词表共享引用，不复制内容
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   decoder:整句解码器
+ */
+void LayeredDictionary::addWordTablesTo(SentenceDecoder &decoder) const
+{
+    for(int i=0;i<layers.size();i++)
+    {
+        const SentenceDecoder *layerDecoder = layers.at(i).index->sentenceDecoder();
+        if(layerDecoder)
+        {
+            decoder.addWordTables(*layerDecoder);
+        }
+    }
+}
+
+int LayeredDictionary::indexOf(const QString &name) const
+{
+    for(int i=0;i<layers.size();i++)
+    {
+        if(layers.at(i).name == name)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,58 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  分层字典，将系统字典、各领域字典、用户字典等多层字典合并查询。
+ * 每层字典是独立的只读索引，通过共享指针引用，可以单独加载、卸载，也可以被多个键盘共享，
+ * 增加一层小字典不需要复制大的系统字典。
+ */
+#ifndef LAYEREDDICTIONARY_H
+#define LAYEREDDICTIONARY_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSharedPointer>
+#include "dictionaryindex.h"
+#include "sentencedecoder.h"
+
+class LayeredDictionary
+{
+public:
+    LayeredDictionary();
+
+    void setLayer(const QString &name,QSharedPointer<const DictionaryIndex> index,
+                  int rankBias=0,const QString &filePath=QString(),bool isMutable=false);//添加或替换一层字典
+    bool removeLayer(const QString &name);//卸载一层字典
+    QSharedPointer<const DictionaryIndex> layer(const QString &name) const;
+    QStringList layerNames() const;
+    QStringList layerFilePaths() const;//所有来自文件的字典路径
+    LayeredDictionary readOnlyLayers() const;//只含只读层的副本
+    int replaceFileLayers(const QString &filePath,QSharedPointer<const DictionaryIndex> index);//替换该文件的字典
+
+    QList<QString> values(const QString &pinyin) const;//合并查询
+    QList<QString> keys(bool includeMutable=true) const;//所有层的拼音(不重复)
+    void addWordTablesTo(SentenceDecoder &decoder) const;//将各层的整句解码词表加入解码器
+    void visitEntries(DictionaryVisitor &visitor,bool includeMutable=true) const;//逐层遍历所有拼音
+    DictionaryIndex::LoadStatistics loadStatistics() const;//各层字典加载统计之和
+
+private:
+    struct Layer
+    {
+        QString name;//层名称
+        QSharedPointer<const DictionaryIndex> index;//该层的字典索引
+        int rankBias;//排序偏移，越小越靠前
+        QString filePath;//字典文件路径，非文件字典为空
+        bool isMutable;//是否会在界面线程修改(如用户字典)，后台线程不访问
+    };
+    int indexOf(const QString &name) const;
+
+    QList<Layer> layers;//按添加顺序排列，排序相同时靠前的层优先
+};
+
+#endif // LAYEREDDICTIONARY_H
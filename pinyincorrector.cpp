@@ -0,0 +1,308 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  拼音纠错，在拼音字典所有键构成的字典树上按有限编辑距离搜索，替换代价依据
+ * 按键的物理相邻关系计算，用于纠正触摸屏上误按相邻按键的输入
+ */
+#include "pinyincorrector.h"
+#include <QElapsedTimer>
+#include <algorithm>
+
+#define DEFAULTNODEBUDGET 20000 //默认单次搜索最多访问的节点数
+#define ADJACENTDISTANCE  1.1   //两按键中心距离(以按键宽度为单位)小于该值视为相邻
+
+PinyinCorrector::PinyinCorrector()
+    :maxEditDistance(1),nodeBudget(DEFAULTNODEBUDGET),visitedNodes(0),isAborted(false)
+{
+    for(int i=0;i<26;i++)
+    {
+        for(int j=0;j<26;j++)
+        {
+            adjacent[i][j] = false;
+        }
+    }
+    clear();
+    resetStatistics();
+}
+/*
+ *@brief:   由拼音字典的键构建字典树，非a-z字母的键被忽略
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   keyList:拼音字典的键
+ */
+void PinyinCorrector::build(const QList<QString> &keyList)
+{
+    clear();
+    for(int i=0;i<keyList.size();i++)
+    {
+        QByteArray key = keyList.at(i).toLatin1();
+        bool isValid = !key.isEmpty();
+        for(int j=0;isValid && j<key.size();j++)
+        {
+            isValid = (key.at(j)>='a' && key.at(j)<='z');
+        }
+        if(!isValid)
+        {
+            continue;
+        }
+        int node = 0;
+        for(int j=0;j<key.size();j++)
+        {
+            int child = findChild(node,key.at(j));
+            if(child < 0)
+            {
+                TrieNode newNode;
+                newNode.firstChild = -1;
+                newNode.nextSibling = nodes.at(node).firstChild;
+                newNode.letter = key.at(j);
+                newNode.isKey = false;
+                child = nodes.size();
+                nodes.append(newNode);
+                nodes[node].firstChild = child;
+            }
+            node = child;
+        }
+        nodes[node].isKey = true;
+    }
+    nodes.squeeze();
+}
+/*
+ *@brief:   清空字典树，只保留根节点
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void PinyinCorrector::clear()
+{
+    nodes.clear();
+    TrieNode root;
+    root.firstChild = -1;
+    root.nextSibling = -1;
+    root.letter = 0;
+    root.isKey = false;
+    nodes.append(root);
+}
+
+bool PinyinCorrector::isEmpty() const
+{
+    return nodes.size() <= 1;
+}
+/*
+ *@brief:   设置按键布局，由各行按键的字母及每行相对第一行的水平偏移计算按键相邻关系
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   rowList:每行按键的字母，如"qwertyuiop"
+ *@param:   offsetList:每行第一个按键相对第一行的水平偏移，以按键宽度为单位
+ */
+void PinyinCorrector::setKeyboardRows(const QStringList &rowList, const QList<double> &offsetList)
+{
+    for(int i=0;i<26;i++)
+    {
+        for(int j=0;j<26;j++)
+        {
+            adjacent[i][j] = false;
+        }
+    }
+    for(int row1=0;row1<rowList.size();row1++)
+    {
+        QByteArray letters1 = rowList.at(row1).toLower().toLatin1();
+        for(int row2=0;row2<rowList.size();row2++)
+        {
+            if(qAbs(row1-row2) > 1)
+            {
+                continue;
+            }
+            QByteArray letters2 = rowList.at(row2).toLower().toLatin1();
+            for(int col1=0;col1<letters1.size();col1++)
+            {
+                for(int col2=0;col2<letters2.size();col2++)
+                {
+                    char letter1 = letters1.at(col1);
+                    char letter2 = letters2.at(col2);
+                    if(letter1<'a' || letter1>'z' || letter2<'a' || letter2>'z' || letter1==letter2)
+                    {
+                        continue;
+                    }
+                    double x1 = col1+offsetList.value(row1,0.0);
+                    double x2 = col2+offsetList.value(row2,0.0);
+                    double dx = x1-x2;
+                    double dy = row1-row2;
+                    if(dx*dx+dy*dy < ADJACENTDISTANCE*ADJACENTDISTANCE)
+                    {
+                        adjacent[letter1-'a'][letter2-'a'] = true;
+                    }
+                }
+            }
+        }
+    }
+}
+/*
+ *@brief:   设置最大编辑距离，限定在1~2之间
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void PinyinCorrector::setMaxDistance(int maxDistance)
+{
+    maxEditDistance = qBound(1,maxDistance,2);
+}
+
+int PinyinCorrector::maxDistance() const
+{
+    return maxEditDistance;
+}
+/*
+ *@brief:   设置单次搜索最多访问的节点数，超出后提前结束搜索，保证每次按键的最坏耗时
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void PinyinCorrector::setNodeBudget(int nodeBudget)
+{
+    this->nodeBudget = qMax(1,nodeBudget);
+}
+
+static bool lessDistance(const QPair<QString,int> &left,const QPair<QString,int> &right)
+{
+    return left.second < right.second;
+}
+/*
+ *@brief:   搜索纠错后的拼音。在字典树上深度优先遍历，每深入一层计算一行编辑距离，
+ * 当该行的最小值已超过最大编辑距离时剪掉整个子树。编辑代价:插入、删除及相邻按键替换为1，
+ * 不相邻按键替换为2。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:输入的拼音
+ *@param:   maxResults:最多返回的拼音个数
+ *@return:  (纠错后的拼音,编辑距离)列表，按编辑距离由小到大排列，不含输入本身
+ */
+QList<QPair<QString, int> > PinyinCorrector::correct(const QString &pinyin, int maxResults)
+{
+    QElapsedTimer timer;
+    timer.start();
+    searchResult.clear();
+    searchInput = pinyin.toLatin1();
+    searchPrefix.clear();
+    visitedNodes = 0;
+    isAborted = false;
+    if(distanceRows.isEmpty())
+    {
+        distanceRows.resize(1);
+    }
+    QVector<int> &firstRow = distanceRows[0];
+    firstRow.resize(searchInput.size()+1);
+    for(int i=0;i<=searchInput.size();i++)
+    {
+        firstRow[i] = i;
+    }
+    for(int child=nodes.at(0).firstChild;child>=0 && !isAborted;child=nodes.at(child).nextSibling)
+    {
+        searchNode(child,1);
+    }
+    std::stable_sort(searchResult.begin(),searchResult.end(),lessDistance);
+    QList<QPair<QString,int> > result = searchResult.mid(0,maxResults);
+
+    stats.visitedNodes += visitedNodes;
+    stats.latency.add(timer.nsecsElapsed());
+    if(isAborted)
+    {
+        stats.abortedCount++;
+    }
+    return result;
+}
+
+PinyinCorrector::Statistics PinyinCorrector::statistics() const
+{
+    return stats;
+}
+
+void PinyinCorrector::resetStatistics()
+{
+    stats.visitedNodes = 0;
+    stats.abortedCount = 0;
+    stats.latency.clear();
+}
+/*
+ *@brief:   查找指定字母的子节点
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@return:  子节点下标，不存在时返回-1
+ */
+int PinyinCorrector::findChild(int node, char letter) const
+{
+    for(int child=nodes.at(node).firstChild;child>=0;child=nodes.at(child).nextSibling)
+    {
+        if(nodes.at(child).letter == letter)
+        {
+            return child;
+        }
+    }
+    return -1;
+}
+/*
+ *@brief:   替换代价，相同为0，相邻按键为1，其他为2
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+int PinyinCorrector::substituteCost(char inputLetter, char keyLetter) const
+{
+    if(inputLetter == keyLetter)
+    {
+        return 0;
+    }
+    if(inputLetter>='a' && inputLetter<='z' && adjacent[inputLetter-'a'][keyLetter-'a'])
+    {
+        return 1;
+    }
+    return 2;
+}
+/*
+ *@brief:   深度优先搜索字典树节点
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   node:当前节点
+ *@param:   depth:节点深度，即当前前缀的长度
+ */
+void PinyinCorrector::searchNode(int node, int depth)
+{
+    if(++visitedNodes > nodeBudget)
+    {
+        isAborted = true;
+        return;
+    }
+    if(distanceRows.size() <= depth)
+    {
+        distanceRows.resize(depth+1);
+    }
+    const QVector<int> &prevRow = distanceRows.at(depth-1);
+    QVector<int> &row = distanceRows[depth];
+    int inputLength = searchInput.size();
+    row.resize(inputLength+1);
+    char letter = nodes.at(node).letter;
+    row[0] = prevRow.at(0)+1;
+    int rowMin = row.at(0);
+    for(int i=1;i<=inputLength;i++)
+    {
+        int cost = qMin(row.at(i-1)+1,prevRow.at(i)+1);
+        cost = qMin(cost,prevRow.at(i-1)+substituteCost(searchInput.at(i-1),letter));
+        row[i] = cost;
+        rowMin = qMin(rowMin,cost);
+    }
+    searchPrefix.append(letter);
+    int distance = row.at(inputLength);
+    if(nodes.at(node).isKey && distance>0 && distance<=maxEditDistance)
+    {
+        searchResult.append(qMakePair(QString::fromLatin1(searchPrefix),distance));
+    }
+    if(rowMin <= maxEditDistance)//剪枝 子树中不可能有编辑距离更小的键
+    {
+        for(int child=nodes.at(node).firstChild;child>=0 && !isAborted;child=nodes.at(child).nextSibling)
+        {
+            searchNode(child,depth+1);
+        }
+    }
+    searchPrefix.chop(1);
+}
@@ -0,0 +1,75 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  拼音纠错，在拼音字典所有键构成的字典树上按有限编辑距离搜索，替换代价依据
+ * 按键的物理相邻关系计算，用于纠正触摸屏上误按相邻按键的输入
+ */
+#ifndef PINYINCORRECTOR_H
+#define PINYINCORRECTOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QPair>
+#include "latencyhistogram.h"
+
+class PinyinCorrector
+{
+public:
+    //搜索开销统计
+    struct Statistics
+    {
+        quint64 visitedNodes;//累计访问的字典树节点数
+        quint64 abortedCount;//超出节点预算而提前结束的次数
+        LatencyHistogram latency;//每次纠错查询的耗时分布
+    };
+
+    PinyinCorrector();
+
+    void build(const QList<QString> &keyList);//由拼音字典的键构建字典树
+    void clear();
+    bool isEmpty() const;
+    void setKeyboardRows(const QStringList &rowList,const QList<double> &offsetList);//设置按键布局
+    void setMaxDistance(int maxDistance);//设置最大编辑距离(1~2)
+    int maxDistance() const;
+    void setNodeBudget(int nodeBudget);//设置单次搜索最多访问的节点数
+    QList<QPair<QString,int> > correct(const QString &pinyin,int maxResults);//搜索纠错后的拼音
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    //字典树节点 子节点以兄弟链表保存，节点紧凑存放在数组中
+    struct TrieNode
+    {
+        int firstChild;
+        int nextSibling;
+        char letter;
+        bool isKey;
+    };
+    int findChild(int node,char letter) const;
+    int substituteCost(char inputLetter,char keyLetter) const;
+    void searchNode(int node,int depth);
+
+    QVector<TrieNode> nodes;//nodes[0]为根节点
+    bool adjacent[26][26];//按键相邻表
+    int maxEditDistance;
+    int nodeBudget;
+    Statistics stats;
+    //单次搜索的状态
+    QByteArray searchInput;
+    QVector<QVector<int> > distanceRows;//每层字典树对应的编辑距离行
+    QByteArray searchPrefix;
+    QList<QPair<QString,int> > searchResult;
+    int visitedNodes;
+    bool isAborted;
+};
+
+#endif // PINYINCORRECTOR_H
@@ -0,0 +1,283 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  拼音字典，读取拼音字典文件构建拼音-汉字哈希表及整句解码词表。
+ * 哈希表构建完成后不再修改，可以在后台线程构建，再整体替换键盘正在使用的字典；
+ * 整句解码词表只在整句模式首次使用时重新读取字典文件构建。
+ */
+#include "pinyindictionary.h"
+#include <QFile>
+#include <QDebug>
+#include <QElapsedTimer>
+
+#define HASHNODEBYTES       (sizeof(void *)*2+sizeof(QString)*2)  //哈希表节点(下一节点、哈希值、键、值)的估算大小
+#define STRINGHEADERBYTES   24  //字符串数据头的估算大小
+
+PinyinDictionary::PinyinDictionary()
+    :decoderNsecs(0)
+{
+    LoadStatistics emptyStats = {0,0,0,0,0,0,0,0,0};
+    stats = emptyStats;
+}
+/*
+ *@brief:   读拼音字典，将汉字与对应拼音存放到hash表中,也可以是QMap中，但不考虑排列顺序时，hash更快
+ * 该函数不涉及界面操作，可以在后台线程中调用
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:拼音字典文件路径
+ *@return:  字典文件是否打开成功
+ */
+bool PinyinDictionary::load(const QString &filePath)
+{
+    QMutexLocker locker(&mutex);
+    dictFilePath = filePath;
+    LoadStatistics emptyStats = {0,0,0,0,0,0,0,0,0};
+    stats = emptyStats;
+    decoder.reset();
+    decoderNsecs = 0;
+    locker.unlock();
+    QFile pinyinFile(filePath);
+    if(!pinyinFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    //逐行读取并插入，读文件及解析、哈希表两部分的耗时分别累加
+    QElapsedTimer timer;
+    timer.start();
+    qint64 lastNsecs = 0;
+    qint64 nsecs;
+    QRegExp regExp("[a-z']+");//正则表达式，匹配1个或多个由a-z及 ' 组成的字母串，默认区分大小写
+    QString lineText;//存放读取的一行数据 汉字-拼音
+    QString linePinyin;//存放正则表达式匹配的拼音
+    QString lineChinese;//存放拼音对应的汉字
+    while(!pinyinFile.atEnd())//while循环读取拼音文件，直到读完
+    {
+        lineText = QString(QString::fromUtf8(pinyinFile.readLine()));
+        splitLine(lineText,regExp,linePinyin,lineChinese);
+        nsecs = timer.nsecsElapsed();
+        stats.readNsecs += nsecs-lastNsecs;
+        lastNsecs = nsecs;
+        if(linePinyin.contains("'"))//如果有单引号表示是词组，则进行拆分词组
+        {
+            splitPhrase(linePinyin,lineChinese);
+            stats.phraseCount++;
+        }
+        else//单个汉字
+        {
+            insertPinyin(linePinyin,lineChinese);//往哈希表插入键值对
+        }
+        nsecs = timer.nsecsElapsed();
+        stats.indexNsecs += nsecs-lastNsecs;
+        lastNsecs = nsecs;
+        stats.entryCount++;
+        stats.stringBytes += STRINGHEADERBYTES+(lineChinese.size()+1)*sizeof(QChar);//汉字在各键间共享
+    }
+    stats.valueCount = chinesePinyin.size();
+    stats.indexBytes = qint64(chinesePinyin.capacity())*sizeof(void *)
+            +qint64(chinesePinyin.size())*HASHNODEBYTES;
+    return true;
+}
+/*
+ *@brief:   获取拼音对应的汉字列表。哈希表一键多值时后插入的先获取，所以常用字在列表后面
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:拼音
+ */
+QList<QString> PinyinDictionary::values(const QString &pinyin) const
+{
+    return chinesePinyin.values(pinyin);
+}
+/*
+ *@brief:   获取所有拼音(不重复)
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+QList<QString> PinyinDictionary::keys() const
+{
+    return chinesePinyin.uniqueKeys();
+}
+/*
+ *@brief:   获取字典构建的整句解码词表，键盘的解码器共享引用该词表。词表只在整句模式首次使用时
+ * 重新读取字典文件构建，非整句模式不占用构建时间和内存
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+const SentenceDecoder *PinyinDictionary::sentenceDecoder() const
+{
+    QMutexLocker locker(&mutex);
+    if(!decoder.isNull())
+    {
+        return decoder.data();
+    }
+    QFile pinyinFile(dictFilePath);
+    if(!pinyinFile.open(QIODevice::ReadOnly))
+    {
+        return 0;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    decoder.reset(new SentenceDecoder());
+    QRegExp regExp("[a-z']+");
+    QString linePinyin;
+    QString lineChinese;
+    while(!pinyinFile.atEnd())
+    {
+        splitLine(QString::fromUtf8(pinyinFile.readLine()),regExp,linePinyin,lineChinese);
+        decoder->addWord(linePinyin,lineChinese);
+    }
+    decoderNsecs = timer.nsecsElapsed();
+    return decoder.data();
+}
+
+/*
+ *@brief:   获取字典规模及各加载阶段的耗时，内存按哈希表节点及字符串数据估算。整句解码词表
+ * 未构建时其耗时为0
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+DictionaryIndex::LoadStatistics PinyinDictionary::loadStatistics() const
+{
+    QMutexLocker locker(&mutex);
+    LoadStatistics loadStats = stats;
+    loadStats.decoderNsecs = decoderNsecs;
+    return loadStats;
+}
+
+QString PinyinDictionary::filePath() const
+{
+    return dictFilePath;
+}
+/*
+ *@brief:   将字典文件的一行拆分为拼音和汉字
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   lineText:一行文本 汉字-拼音
+ *@param:   regExp:匹配拼音的正则表达式
+ *@param:   pinyin:输出拼音
+ *@param:   chinese:输出汉字
+ */
+void PinyinDictionary::splitLine(const QString &lineText, QRegExp &regExp, QString &pinyin, QString &chinese)
+{
+    int pinyinPosition = regExp.indexIn(lineText,0);//获取读取行的文本中匹配正则表达式的位置
+    pinyin = regExp.cap(0);//regExp.cap(0)表示完整正则表达式的匹配
+    chinese = lineText.left(pinyinPosition);//lineText.left(n)可以获取左边那个字符即对应的汉字
+}
+/*
+ *@brief:   向哈希表插入拼音-汉字键值对，同时统计不重复的拼音个数及拼音占用的内存
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:拼音
+ *@param:   chinese:拼音对应的汉字
+ */
+void PinyinDictionary::insertPinyin(const QString &pinyin, const QString &chinese)
+{
+    if(!chinesePinyin.contains(pinyin))
+    {
+        stats.keyCount++;
+    }
+    chinesePinyin.insert(pinyin,chinese);
+    stats.stringBytes += STRINGHEADERBYTES+(pinyin.size()+1)*sizeof(QChar);
+}
+/*
+ *@brief:   拆分拼音词组，拼音字典文件词组用'分割，如"ai'qing"该函数的功能便是去掉'，
+ * 将简拼、全拼存放到哈希表中
+ *@author:  缪庆瑞
+ *@date:    2017.2.7
+ *@param:   phrase:要处理的拼音词组
+ *@param:   chinese:拼音对应的汉字
+ */
+void PinyinDictionary::splitPhrase(QString phrase,QString chinese)
+{
+    int count = phrase.count("'");
+    if(count==1)//两个汉字
+    {
+        int index=phrase.indexOf("'");
+        QString pinyin1=phrase.left(1);//两字首字母简拼 例aq
+        pinyin1.append(phrase.at(index+1));
+        insertPinyin(pinyin1,chinese);
+        QString pinyin2=phrase.left(index);//全拼+首字母 aiq
+        pinyin2.append(phrase.at(index+1));
+        if(pinyin2!=pinyin1)//避免同一词组键值对插入哈希表多次 例如 e'xi
+        {
+            insertPinyin(pinyin2,chinese);
+        }
+        QString pinyin3=phrase.remove("'");//全拼 aiqing
+        if(pinyin3!=pinyin2)
+        {
+             insertPinyin(pinyin3,chinese);
+        }
+    }
+    else if(count==2)//三个汉字
+    {
+        int index1=phrase.indexOf("'");
+        int index2=phrase.indexOf("'",index1+1);
+        QString pinyin1=phrase.left(1);//三字首字母简拼
+        pinyin1.append(phrase.at(index1+1));
+        pinyin1.append(phrase.at(index2+1));
+        insertPinyin(pinyin1,chinese);
+        QString pinyin2=phrase.left(index1);//全拼+首字母+首字母
+        pinyin2.append(phrase.at(index1+1));
+        pinyin2.append(phrase.at(index2+1));
+        if(pinyin2!=pinyin1)//避免同一词组键值对插入哈希表多次 例如 e'xi
+        {
+            insertPinyin(pinyin2,chinese);
+        }
+        QString pinyin3=phrase.left(index2);//全拼+全拼+首字母
+        pinyin3.append(phrase.at(index2+1));
+        pinyin3.remove("'");
+        if(pinyin3!=pinyin2)//避免同一词组键值对插入哈希表多次 例如 e'xi
+        {
+            insertPinyin(pinyin3,chinese);
+        }
+        QString pinyin4=phrase.remove("'");//全拼
+        if(pinyin4!=pinyin3)//避免同一词组键值对插入哈希表多次 例如 e'xi
+        {
+            insertPinyin(pinyin4,chinese);
+        }
+    }
+    else if(count==3)//四个汉字
+    {
+        int index1=phrase.indexOf("'");
+        int index2=phrase.indexOf("'",index1+1);
+        int index3=phrase.indexOf("'",index2+1);
+        QString pinyin1=phrase.left(1);//四字首字母简拼
+        pinyin1.append(phrase.at(index1+1));
+        pinyin1.append(phrase.at(index2+1));
+        pinyin1.append(phrase.at(index3+1));
+        insertPinyin(pinyin1,chinese);
+        QString pinyin2=phrase.left(index1);//全拼+首字母+首字母+首字母
+        pinyin2.append(phrase.at(index1+1));
+        pinyin2.append(phrase.at(index2+1));
+        pinyin2.append(phrase.at(index3+1));
+        if(pinyin2!=pinyin1)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        {
+            insertPinyin(pinyin2,chinese);
+        }
+        QString pinyin3=phrase.left(index2);//全拼+全拼+首字母+首字母
+        pinyin3.append(phrase.at(index2+1));
+        pinyin3.append(phrase.at(index3+1));
+        pinyin3.remove("'");
+        if(pinyin3!=pinyin2)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        {
+            insertPinyin(pinyin3,chinese);
+        }
+        QString pinyin4=phrase.left(index3);//全拼+全拼+全拼+首字母
+        pinyin4.append(phrase.at(index3+1));
+        pinyin4.remove("'");
+        if(pinyin4!=pinyin3)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        {
+            insertPinyin(pinyin4,chinese);
+        }
+        QString pinyin5=phrase.remove("'");//全拼
+        if(pinyin5!=pinyin4)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        {
+            insertPinyin(pinyin5,chinese);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  拼音字典，读取拼音字典文件构建拼音-汉字哈希表及整句解码词表。
+ * 构建完成后不再修改，可以在后台线程构建，再整体替换键盘正在使用的字典。
+ */
+#ifndef PINYINDICTIONARY_H
+#define PINYINDICTIONARY_H
+
+#include <QString>
+#include <QStringList>
+#include <QMultiHash>
+#include <QList>
+#include <QRegExp>
+#include <QMutex>
+#include <QScopedPointer>
+#include "sentencedecoder.h"
+#include "dictionaryindex.h"
+
+class PinyinDictionary : public DictionaryIndex
+{
+public:
+    PinyinDictionary();
+
+    bool load(const QString &filePath);//读拼音字典文件
+    QList<QString> values(const QString &pinyin) const;//获取拼音对应的汉字列表
+    QList<QString> keys() const;//所有拼音(不重复)
+    const SentenceDecoder *sentenceDecoder() const;//整句解码词表，首次使用时构建
+    LoadStatistics loadStatistics() const;//字典规模及加载耗时
+    QString filePath() const;
+
+private:
+    static void splitLine(const QString &lineText,QRegExp &regExp,QString &pinyin,QString &chinese);//拆分一行为拼音和汉字
+    void splitPhrase(QString phrase,QString chinese);//拆分拼音词组
+    void insertPinyin(const QString &pinyin,const QString &chinese);//插入键值对并统计
+
+    QString dictFilePath;//字典文件路径
+    QMultiHash<QString,QString> chinesePinyin;//使用哈希表来存放拼音汉字的键值对 一键多值
+    LoadStatistics stats;
+    mutable QMutex mutex;//保护整句解码词表的延迟构建，查询可能来自界面线程和后台线程
+    mutable QScopedPointer<SentenceDecoder> decoder;//整句解码器词表
+    mutable qint64 decoderNsecs;//构建整句解码词表的耗时(ns)
+};
+
+#endif // PINYINDICTIONARY_H
@@ -0,0 +1,189 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  汉语拼音音节表，提供音节合法性判断以及连续拼音串的音节切分
+ */
+#include "pinyinsyllable.h"
+#include <QVector>
+
+//全部合法音节 ü统一用v表示，同时兼容拼音字典中lue/nue的写法
+static const char *const SYLLABLE_TABLE[] = {
+    "a","ai","an","ang","ao",
+    "ba","bai","ban","bang","bao","bei","ben","beng","bi","bian","biao","bie","bin","bing","bo","bu",
+    "ca","cai","can","cang","cao","ce","cen","ceng","cha","chai","chan","chang","chao","che","chen",
+    "cheng","chi","chong","chou","chu","chua","chuai","chuan","chuang","chui","chun","chuo","ci",
+    "cong","cou","cu","cuan","cui","cun","cuo",
+    "da","dai","dan","dang","dao","de","dei","den","deng","di","dia","dian","diao","die","ding","diu",
+    "dong","dou","du","duan","dui","dun","duo",
+    "e","ei","en","eng","er",
+    "fa","fan","fang","fei","fen","feng","fo","fou","fu",
+    "ga","gai","gan","gang","gao","ge","gei","gen","geng","gong","gou","gu","gua","guai","guan",
+    "guang","gui","gun","guo",
+    "ha","hai","han","hang","hao","he","hei","hen","heng","hong","hou","hu","hua","huai","huan",
+    "huang","hui","hun","huo",
+    "ji","jia","jian","jiang","jiao","jie","jin","jing","jiong","jiu","ju","juan","jue","jun",
+    "ka","kai","kan","kang","kao","ke","kei","ken","keng","kong","kou","ku","kua","kuai","kuan",
+    "kuang","kui","kun","kuo",
+    "la","lai","lan","lang","lao","le","lei","leng","li","lia","lian","liang","liao","lie","lin",
+    "ling","liu","lo","long","lou","lu","luan","lue","lun","luo","lv","lve",
+    "ma","mai","man","mang","mao","me","mei","men","meng","mi","mian","miao","mie","min","ming",
+    "miu","mo","mou","mu",
+    "na","nai","nan","nang","nao","ne","nei","nen","neng","ni","nian","niang","niao","nie","nin",
+    "ning","niu","nong","nou","nu","nuan","nue","nuo","nv","nve",
+    "o","ou",
+    "pa","pai","pan","pang","pao","pei","pen","peng","pi","pian","piao","pie","pin","ping","po",
+    "pou","pu",
+    "qi","qia","qian","qiang","qiao","qie","qin","qing","qiong","qiu","qu","quan","que","qun",
+    "ran","rang","rao","re","ren","reng","ri","rong","rou","ru","rua","ruan","rui","run","ruo",
+    "sa","sai","san","sang","sao","se","sen","seng","sha","shai","shan","shang","shao","she","shei",
+    "shen","sheng","shi","shou","shu","shua","shuai","shuan","shuang","shui","shun","shuo","si",
+    "song","sou","su","suan","sui","sun","suo",
+    "ta","tai","tan","tang","tao","te","tei","teng","ti","tian","tiao","tie","ting","tong","tou",
+    "tu","tuan","tui","tun","tuo",
+    "wa","wai","wan","wang","wei","wen","weng","wo","wu",
+    "xi","xia","xian","xiang","xiao","xie","xin","xing","xiong","xiu","xu","xuan","xue","xun",
+    "ya","yan","yang","yao","ye","yi","yin","ying","yo","yong","you","yu","yuan","yue","yun",
+    "za","zai","zan","zang","zao","ze","zei","zen","zeng","zha","zhai","zhan","zhang","zhao","zhe",
+    "zhei","zhen","zheng","zhi","zhong","zhou","zhu","zhua","zhuai","zhuan","zhuang","zhui","zhun",
+    "zhuo","zi","zong","zou","zu","zuan","zui","zun","zuo",
+    0
+};
+#define MAXSYLLABLELENGTH 6 //最长音节如zhuang、chuang、shuang
+
+/*
+ *@brief:   判断是否为完整的合法音节
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   text:待判断的拼音
+ */
+bool PinyinSyllable::isSyllable(const QString &text)
+{
+    return syllables().contains(text);
+}
+/*
+ *@brief:   判断是否为某个合法音节的前缀，完整音节本身也算作前缀
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   text:待判断的拼音
+ */
+bool PinyinSyllable::isSyllablePrefix(const QString &text)
+{
+    return syllablePrefixes().contains(text);
+}
+/*
+ *@brief:   音节的最大长度，拼音串切分时以此限定查找窗口
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+int PinyinSyllable::maxSyllableLength()
+{
+    return MAXSYLLABLELENGTH;
+}
+/*
+ *@brief:   将连续的拼音串切分为音节，以音节数最少为原则，音节数相同时优先让前面的音节更长
+ * (例:xian切分为xian而不是xi'an，fangan切分为fang'an)。若拼音串无法完整切分(如输入到一半的
+ * 音节或简拼)，则从前往后按最长音节匹配，剩余部分作为最后一段原样返回。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:连续的拼音串，不含分隔符'
+ *@return:  切分后的音节列表
+ */
+QStringList PinyinSyllable::split(const QString &pinyin)
+{
+    QStringList result;
+    int length = pinyin.length();
+    if(length == 0)
+    {
+        return result;
+    }
+    //从后往前动态规划 count[i]表示覆盖[i,length)所需的最少音节数，step[i]为该位置选取的音节长度
+    const int unreachable = length+1;
+    QVector<int> count(length+1,unreachable);
+    QVector<int> step(length+1,0);
+    count[length] = 0;
+    for(int i=length-1;i>=0;i--)
+    {
+        for(int len=qMin(MAXSYLLABLELENGTH,length-i);len>0;len--)
+        {
+            if(count[i+len]<unreachable && count[i+len]+1<count[i] && isSyllable(pinyin.mid(i,len)))
+            {
+                count[i] = count[i+len]+1;
+                step[i] = len;
+            }
+        }
+    }
+    int pos = 0;
+    if(count[0]<unreachable)//可以完整切分
+    {
+        while(pos<length)
+        {
+            result.append(pinyin.mid(pos,step[pos]));
+            pos += step[pos];
+        }
+        return result;
+    }
+    //无法完整切分 按最长音节依次匹配
+    while(pos<length)
+    {
+        int len = qMin(MAXSYLLABLELENGTH,length-pos);
+        while(len>0 && !isSyllable(pinyin.mid(pos,len)))
+        {
+            len--;
+        }
+        if(len == 0)
+        {
+            break;
+        }
+        result.append(pinyin.mid(pos,len));
+        pos += len;
+    }
+    if(pos<length)
+    {
+        result.append(pinyin.mid(pos));
+    }
+    return result;
+}
+/*
+ *@brief:   获取所有合法音节的集合，首次调用时由音节表构建
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+const QSet<QString> &PinyinSyllable::syllables()
+{
+    static QSet<QString> syllableSet;
+    if(syllableSet.isEmpty())
+    {
+        for(int i=0;SYLLABLE_TABLE[i];i++)
+        {
+            syllableSet.insert(QString::fromLatin1(SYLLABLE_TABLE[i]));
+        }
+    }
+    return syllableSet;
+}
+/*
+ *@brief:   获取所有合法音节前缀的集合，首次调用时由音节表构建
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+const QSet<QString> &PinyinSyllable::syllablePrefixes()
+{
+    static QSet<QString> prefixSet;
+    if(prefixSet.isEmpty())
+    {
+        for(int i=0;SYLLABLE_TABLE[i];i++)
+        {
+            QString syllable = QString::fromLatin1(SYLLABLE_TABLE[i]);
+            for(int len=1;len<=syllable.length();len++)
+            {
+                prefixSet.insert(syllable.left(len));
+            }
+        }
+    }
+    return prefixSet;
+}
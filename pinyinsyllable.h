@@ -0,0 +1,33 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  汉语拼音音节表，提供音节合法性判断以及连续拼音串的音节切分
+ */
+#ifndef PINYINSYLLABLE_H
+#define PINYINSYLLABLE_H
+
+#include <QString>
+#include <QStringList>
+#include <QSet>
+
+class PinyinSyllable
+{
+public:
+    static bool isSyllable(const QString &text);//是否为完整的合法音节
+    static bool isSyllablePrefix(const QString &text);//是否为某个合法音节的前缀(含完整音节)
+    static int maxSyllableLength();//音节的最大长度
+    static QStringList split(const QString &pinyin);//将连续的拼音串切分为音节
+    static const QSet<QString> &syllables();//所有合法音节
+
+private:
+    PinyinSyllable();
+    static const QSet<QString> &syllablePrefixes();
+};
+
+#endif // PINYINSYLLABLE_H
@@ -0,0 +1,240 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  键盘界面渲染基准测试，在offscreen平台下驱动键盘的首次显示、在最小大小(450x300)
+ * 与默认大小(800x480)之间缩放，以及大小写、数字字母与符号、中英文切换，测量每帧的布局
+ * 和绘制耗时及重绘的部件数，结果以JSON输出，便于在发布前发现界面性能的退化。
+ *
+ * 用法: renderbench [-n 每项帧数] [-o 结果文件] [--workdir 字典所在目录]
+ * 未设置QT_QPA_PLATFORM时默认使用offscreen平台。
+ */
+#include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTextStream>
+#include "softkeyboard.h"
+
+#define DEFAULTFRAMES   20  //每项测试的默认帧数
+#define MINWIDTH        450
+#define MINHEIGHT       300
+#define DEFAULTWIDTH    800
+#define DEFAULTHEIGHT   480
+
+/*绘制事件计数，统计一帧内收到绘制事件的部件*/
+class PaintCounter : public QObject
+{
+public:
+    PaintCounter() : paintEvents(0)
+    {
+    }
+    void reset()
+    {
+        paintEvents = 0;
+        paintedWidgets.clear();
+    }
+    int paintEventCount() const
+    {
+        return paintEvents;
+    }
+    int paintedWidgetCount() const
+    {
+        return paintedWidgets.size();
+    }
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event)
+    {
+        if(event->type() == QEvent::Paint)
+        {
+            paintEvents++;
+            paintedWidgets.insert(watched);
+        }
+        return QObject::eventFilter(watched,event);
+    }
+
+private:
+    int paintEvents;
+    QSet<QObject *> paintedWidgets;
+};
+
+//一帧的测量结果
+struct FrameSample
+{
+    qint64 layoutNsecs;//处理布局请求的耗时
+    qint64 paintNsecs;//处理其余事件(主要是重绘)的耗时
+    int paintEvents;
+    int paintedWidgets;
+};
+/*
+ *@brief:   渲染一帧。先处理挂起的布局请求，再处理其余挂起的事件，界面的重绘在此完成
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static FrameSample renderFrame(PaintCounter &counter)
+{
+    FrameSample sample;
+    counter.reset();
+    QElapsedTimer timer;
+    timer.start();
+    QCoreApplication::sendPostedEvents(0,QEvent::LayoutRequest);
+    sample.layoutNsecs = timer.nsecsElapsed();
+    timer.restart();
+    QCoreApplication::processEvents();
+    sample.paintNsecs = timer.nsecsElapsed();
+    sample.paintEvents = counter.paintEventCount();
+    sample.paintedWidgets = counter.paintedWidgetCount();
+    return sample;
+}
+/*
+ *@brief:   汇总一项测试的所有帧，耗时单位为ms
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static QJsonObject summarize(const QString &name,const QList<FrameSample> &samples)
+{
+    qint64 totalLayout = 0,maxLayout = 0,totalPaint = 0,maxPaint = 0;
+    qint64 totalWidgets = 0;
+    int maxWidgets = 0;
+    QJsonArray frames;
+    for(int i=0;i<samples.size();i++)
+    {
+        const FrameSample &sample = samples.at(i);
+        totalLayout += sample.layoutNsecs;
+        maxLayout = qMax(maxLayout,sample.layoutNsecs);
+        totalPaint += sample.paintNsecs;
+        maxPaint = qMax(maxPaint,sample.paintNsecs);
+        totalWidgets += sample.paintedWidgets;
+        maxWidgets = qMax(maxWidgets,sample.paintedWidgets);
+        QJsonObject frame;
+        frame.insert("layoutMs",sample.layoutNsecs/1e6);
+        frame.insert("paintMs",sample.paintNsecs/1e6);
+        frame.insert("paintEvents",sample.paintEvents);
+        frame.insert("paintedWidgets",sample.paintedWidgets);
+        frames.append(frame);
+    }
+    int count = qMax(1,samples.size());
+    QJsonObject result;
+    result.insert("name",name);
+    result.insert("frames",samples.size());
+    result.insert("meanLayoutMs",totalLayout/1e6/count);
+    result.insert("maxLayoutMs",maxLayout/1e6);
+    result.insert("meanPaintMs",totalPaint/1e6/count);
+    result.insert("maxPaintMs",maxPaint/1e6);
+    result.insert("meanFrameMs",(totalLayout+totalPaint)/1e6/count);
+    result.insert("meanPaintedWidgets",double(totalWidgets)/count);
+    result.insert("maxPaintedWidgets",maxWidgets);
+    result.insert("samples",frames);
+    return result;
+}
+/*
+ *@brief:   重复调用键盘的槽函数(切换按键显示)，每次调用后渲染一帧
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static QJsonObject benchmarkSlot(const QString &name,SoftKeyboard *keyboard,const char *slot,
+                                 int frameCount,PaintCounter &counter)
+{
+    QList<FrameSample> samples;
+    for(int i=0;i<frameCount;i++)
+    {
+        QMetaObject::invokeMethod(keyboard,slot,Qt::DirectConnection);
+        samples.append(renderFrame(counter));
+    }
+    return summarize(name,samples);
+}
+
+int main(int argc, char *argv[])
+{
+    if(qgetenv("QT_QPA_PLATFORM").isEmpty())
+    {
+        qputenv("QT_QPA_PLATFORM","offscreen");
+    }
+    QApplication app(argc,argv);
+    QStringList arguments = app.arguments();
+    int frameCount = DEFAULTFRAMES;
+    QString outputPath;
+    for(int i=1;i<arguments.size();i++)
+    {
+        bool hasValue = (i+1<arguments.size());
+        if(arguments.at(i) == "-n" && hasValue)
+        {
+            frameCount = qMax(1,arguments.at(++i).toInt());
+        }
+        else if(arguments.at(i) == "-o" && hasValue)
+        {
+            outputPath = arguments.at(++i);
+        }
+        else if(arguments.at(i) == "--workdir" && hasValue)
+        {
+            QDir::setCurrent(arguments.at(++i));//键盘按相对路径读取字典
+        }
+        else
+        {
+            QTextStream(stderr)<<"usage: renderbench [-n frames] [-o result.json] [--workdir dir]\n";
+            return 2;
+        }
+    }
+    PaintCounter counter;
+    app.installEventFilter(&counter);
+    QJsonArray benchmarks;
+    /*****************构造及首次显示*****************/
+    QElapsedTimer timer;
+    timer.start();
+    SoftKeyboard *keyboard = new SoftKeyboard();
+    qint64 constructNsecs = timer.nsecsElapsed();
+    keyboard->show();
+    QList<FrameSample> firstShow;
+    firstShow.append(renderFrame(counter));
+    QJsonObject firstShowResult = summarize("firstShow",firstShow);
+    firstShowResult.insert("constructMs",constructNsecs/1e6);
+    benchmarks.append(firstShowResult);
+    /*****************缩放*****************/
+    QList<FrameSample> resizeSamples;
+    for(int i=0;i<frameCount;i++)
+    {
+        if(i%2 == 0)
+        {
+            keyboard->resize(MINWIDTH,MINHEIGHT);
+        }
+        else
+        {
+            keyboard->resize(DEFAULTWIDTH,DEFAULTHEIGHT);
+        }
+        resizeSamples.append(renderFrame(counter));
+    }
+    benchmarks.append(summarize("resize",resizeSamples));
+    keyboard->resize(DEFAULTWIDTH,DEFAULTHEIGHT);
+    renderFrame(counter);
+    /*****************按键显示切换*****************/
+    benchmarks.append(benchmarkSlot("changeUpperLower",keyboard,"changeUpperLowerSlot",frameCount,counter));
+    benchmarks.append(benchmarkSlot("changeLetterSymbol",keyboard,"changeLetterSymbolSlot",frameCount,counter));
+    benchmarks.append(benchmarkSlot("changeChEn",keyboard,"changeChEnSlot",frameCount,counter));
+
+    QJsonObject result;
+    result.insert("platform",QApplication::platformName());
+    result.insert("qtVersion",QString(qVersion()));
+    result.insert("widgetCount",keyboard->findChildren<QWidget *>().size()+1);
+    result.insert("benchmarks",benchmarks);
+    QByteArray json = QJsonDocument(result).toJson();
+    delete keyboard;
+    QFile outputFile(outputPath);
+    bool isOpened = outputPath.isEmpty()?outputFile.open(stdout,QIODevice::WriteOnly)
+                                        :outputFile.open(QIODevice::WriteOnly|QIODevice::Truncate);
+    if(!isOpened || outputFile.write(json) != json.size())
+    {
+        QTextStream(stderr)<<outputPath<<": cannot write\n";
+        return 1;
+    }
+    return 0;
+}
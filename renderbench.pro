@@ -0,0 +1,59 @@
+#-------------------------------------------------
+#
+# 键盘界面渲染基准测试，在offscreen平台下测量首次显示、缩放及按键切换的每帧耗时
+# 例: renderbench --workdir . -o renderbench.json
+#
+#-------------------------------------------------
+
+QT       += core gui widgets concurrent
+
+lessThan(QT_MAJOR_VERSION, 5): error("renderbench requires Qt 5 (offscreen platform and QJsonDocument)")
+
+TARGET = renderbench
+CONFIG += console
+CONFIG -= app_bundle
+OBJECTS_DIR = .obj/$$TARGET  #与键盘共用的源文件编译选项不同，中间文件分开存放
+MOC_DIR = .moc/$$TARGET
+TEMPLATE = app
+
+
+SOURCES += renderbench.cpp \
+    softkeyboard.cpp \
+    pinyinsyllable.cpp \
+    sentencedecoder.cpp \
+    userdictionary.cpp \
+    fuzzypinyin.cpp \
+    pinyincorrector.cpp \
+    pinyindictionary.cpp \
+    layereddictionary.cpp \
+    compresseddictionary.cpp \
+    englishcompleter.cpp \
+    t9index.cpp \
+    textpixmapcache.cpp \
+    candidatebar.cpp \
+    touchkeyinput.cpp \
+    snippettable.cpp \
+    strokeindex.cpp \
+    latencyhistogram.cpp \
+    runtimestatistics.cpp
+
+HEADERS  += \
+    softkeyboard.h \
+    pinyinsyllable.h \
+    sentencedecoder.h \
+    userdictionary.h \
+    fuzzypinyin.h \
+    pinyincorrector.h \
+    pinyindictionary.h \
+    dictionaryindex.h \
+    layereddictionary.h \
+    compresseddictionary.h \
+    englishcompleter.h \
+    t9index.h \
+    textpixmapcache.h \
+    candidatebar.h \
+    touchkeyinput.h \
+    snippettable.h \
+    strokeindex.h \
+    latencyhistogram.h \
+    runtimestatistics.h
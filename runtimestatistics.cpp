@@ -0,0 +1,66 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  键盘运行统计快照，汇总字典规模、内存、加载各阶段耗时以及每次按键的匹配、显示、
+ * 绘制耗时分布和各功能模块的开销统计。快照是值拷贝，获取后可以在任意线程记录或分析
+ */
+#include "runtimestatistics.h"
+#include <QStringList>
+
+/*
+ *@brief:   每个词组拆分出的平均拼音键数。单字各占一个键，其余的键值对都由词组拆分得到
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+double RuntimeStatistics::keyExpansionFactor() const
+{
+    if(dictionary.phraseCount == 0)
+    {
+        return 0;
+    }
+    int phraseKeyCount = dictionary.valueCount-(dictionary.entryCount-dictionary.phraseCount);
+    return double(phraseKeyCount)/dictionary.phraseCount;
+}
+
+qint64 RuntimeStatistics::totalBytes() const
+{
+    return dictionary.indexBytes+dictionary.stringBytes+candidateBytes
+            +textCache.totalBytes+residency.residentBytes;
+}
+
+QString RuntimeStatistics::toString() const
+{
+    QStringList lineList;
+    lineList<<QString("dictionary: layers=%1 generation=%2 entries=%3 phrases=%4 keys=%5 values=%6 expansion=%7")
+              .arg(layerCount).arg(dictionaryGeneration).arg(dictionary.entryCount).arg(dictionary.phraseCount)
+              .arg(dictionary.keyCount).arg(dictionary.valueCount).arg(keyExpansionFactor(),0,'f',2);
+    lineList<<QString("load: total=%1ms read=%2ms index=%3ms decoder=%4ms")
+              .arg(dictionaryLoadNsecs/1000000).arg(dictionary.readNsecs/1000000)
+              .arg(dictionary.indexNsecs/1000000).arg(dictionary.decoderNsecs/1000000);
+    lineList<<QString("memory: total=%1KB index=%2KB strings=%3KB candidates=%4KB pixmaps=%5KB pages=%6KB widgets=%7")
+              .arg(totalBytes()/1024).arg(dictionary.indexBytes/1024).arg(dictionary.stringBytes/1024)
+              .arg(candidateBytes/1024).arg(textCache.totalBytes/1024).arg(residency.residentBytes/1024)
+              .arg(widgetCount);
+    lineList<<QString("match: ")+matchHistogram.toString();
+    lineList<<QString("display: ")+displayHistogram.toString();
+    lineList<<QString("paint: ")+paintHistogram.toString();
+    lineList<<QString("touch: points=%1 commits=%2 ").arg(touchInput.touchPointCount).arg(touchInput.commitCount)
+              +touchInput.commitLatency.toString();
+    lineList<<QString("text cache: hits=%1 renders=%2 pixmaps=%3")
+              .arg(textCache.hitCount).arg(textCache.renderCount).arg(textCache.pixmapCount);
+    lineList<<QString("pages: lookups=%1 hits=%2 ").arg(residency.lookupCount).arg(residency.cacheHitCount)
+              +residency.pageInLatency.toString();
+    lineList<<QString("fuzzy: ")+fuzzyPinyin.latency.toString();
+    lineList<<QString("correction: ")+typoCorrection.latency.toString();
+    lineList<<QString("english: ")+englishCompletion.latency.toString();
+    lineList<<QString("snippet: ")+snippet.latency.toString();
+    lineList<<QString("t9: ")+t9.latency.toString();
+    lineList<<QString("stroke: ")+stroke.latency.toString();
+    return lineList.join("\n");
+}
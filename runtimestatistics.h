@@ -0,0 +1,58 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  键盘运行统计快照，汇总字典规模、内存、加载各阶段耗时以及每次按键的匹配、显示、
+ * 绘制耗时分布和各功能模块的开销统计。快照是值拷贝，获取后可以在任意线程记录或分析
+ */
+#ifndef RUNTIMESTATISTICS_H
+#define RUNTIMESTATISTICS_H
+
+#include <QString>
+#include "dictionaryindex.h"
+#include "compresseddictionary.h"
+#include "fuzzypinyin.h"
+#include "pinyincorrector.h"
+#include "englishcompleter.h"
+#include "snippettable.h"
+#include "t9index.h"
+#include "strokeindex.h"
+#include "textpixmapcache.h"
+#include "touchkeyinput.h"
+#include "latencyhistogram.h"
+
+struct RuntimeStatistics
+{
+    //字典
+    int layerCount;//字典层数
+    int dictionaryGeneration;//字典层改变的次数
+    DictionaryIndex::LoadStatistics dictionary;//各层字典规模及加载耗时之和
+    qint64 dictionaryLoadNsecs;//最近一次加载系统字典的总耗时(ns)，包括文件改变后的重新加载
+    //内存
+    qint64 candidateBytes;//当前候选词列表文本占用的内存(字节)
+    int widgetCount;//键盘的部件个数
+    TextPixmapCache::Statistics textCache;//按键及候选词文字图片
+    CompressedDictionary::Statistics residency;//压缩字典页面缓存
+    //每次按键
+    LatencyHistogram matchHistogram;//匹配候选词
+    LatencyHistogram displayHistogram;//候选词填充候选条
+    LatencyHistogram paintHistogram;//候选条绘制
+    TouchKeyInput::Statistics touchInput;
+    FuzzyPinyin::Statistics fuzzyPinyin;
+    PinyinCorrector::Statistics typoCorrection;
+    EnglishCompleter::Statistics englishCompletion;
+    SnippetTable::Statistics snippet;
+    T9Index::Statistics t9;
+    StrokeIndex::Statistics stroke;
+
+    double keyExpansionFactor() const;//每个词组拆分出的平均拼音键数
+    qint64 totalBytes() const;//索引、文本及文字图片的估算内存之和
+    QString toString() const;//多行文本，用于日志
+};
+
+#endif // RUNTIMESTATISTICS_H
@@ -0,0 +1,408 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  整句转换解码器，在拼音词格上用Viterbi动态规划求出代价最小的汉字句子。
+ * 词的代价由其在字典候选词中的排名决定，词与词之间的转移代价可由用户连续上屏的词学习得到。
+ */
+#include "sentencedecoder.h"
+#include "pinyinsyllable.h"
+#include <QStringList>
+
+#define TRANSITIONCOST      1.0     //词与词之间的转移代价，使解码倾向于用更少、更长的词
+#define SINGLECHARCOST      0.5     //单字的额外代价，单字组句的可信度低于词组
+#define RANKCOST            0.2     //候选词每靠后一位增加的代价，字典文件中同一拼音的常用词在前
+#define MAXWORDSPERKEY      4       //同一全拼保留的词数
+#define MAXLATTICESTATES    8       //每个词格节点保留的状态数
+#define UNREACHABLECOST     1e30    //不可到达节点的代价
+
+SentenceDecoder::SentenceDecoder()
+    :maxKeyLength(0)
+{
+}
+/*
+ *@brief:   清空词表、转移代价及词格
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SentenceDecoder::clear()
+{
+    wordTable.clear();
+    sharedTables.clear();
+    transitionTable.clear();
+    maxKeyLength = 0;
+    reset();
+}
+/*
+ *@brief:   向词表添加一个词。只接受由合法音节组成且音节数与汉字数一致的全拼，字典中的简拼
+ * 条目(如b、zh)不参与组句。词的代价由其在同一全拼已添加词中的排名决定，即字典文件中靠前的
+ * 常用词代价小，每个全拼只保留代价最小的几个词。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   phrase:字典中的拼音，词组用'分隔
+ *@param:   word:拼音对应的汉字
+ *@param:   extraCost:额外代价，可用于调整个别词的优先级
+ */
+void SentenceDecoder::addWord(const QString &phrase, const QString &word, double extraCost)
+{
+    QString key = phrase;
+    key.remove("'");
+    QString chinese = word;
+    chinese.remove(QChar(0xFEFF));//字典文件首行可能带有BOM
+    if(key.isEmpty() || chinese.isEmpty())
+    {
+        return;
+    }
+    QStringList syllableList = PinyinSyllable::split(key);
+    if(syllableList.size() != chinese.length())
+    {
+        return;
+    }
+    for(int i=0;i<syllableList.size();i++)
+    {
+        if(!PinyinSyllable::isSyllable(syllableList.at(i)))
+        {
+            return;
+        }
+    }
+    DecoderWordList &wordList = wordTable[key];
+    DecoderWord decoderWord;
+    decoderWord.word = chinese;
+    decoderWord.cost = extraCost+RANKCOST*wordList.size();
+    if(chinese.length() == 1)
+    {
+        decoderWord.cost += SINGLECHARCOST;
+    }
+    insertWord(wordList,decoderWord);
+    maxKeyLength = qMax(maxKeyLength,key.length());
+    reset();//词表改变后原有词格失效
+}
+/*
+ *@brief:   共享引用另一个解码器的词表，用于多个字典合并解码。词表是隐式共享的，这里只增加
+ * 引用计数，不会复制大的系统词表；查找时各个词表的词都参与解码。转移代价属于各自的解码器，
+ * 不共享。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   other:另一个解码器
+ */
+void SentenceDecoder::addWordTables(const SentenceDecoder &other)
+{
+    sharedTables.append(other.sharedTables);
+    if(!other.wordTable.isEmpty())
+    {
+        sharedTables.append(other.wordTable);
+    }
+    maxKeyLength = qMax(maxKeyLength,other.maxKeyLength);
+    reset();
+}
+/*
+ *@brief:   添加两个词相邻出现的转移代价修正值，如用户连续选择的两个词，解码时这两个词相邻的
+ * 路径代价减小。同一对词多次添加时保留最小值。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   prevWord:前一个词
+ *@param:   word:后一个词
+ *@param:   cost:转移代价的修正值，在默认转移代价上累加，负值表示更可能相邻
+ */
+void SentenceDecoder::addTransition(const QString &prevWord, const QString &word, double cost)
+{
+    if(prevWord.isEmpty() || word.isEmpty())
+    {
+        return;
+    }
+    QHash<QString,double> &nextTable = transitionTable[prevWord];
+    QHash<QString,double>::iterator it = nextTable.find(word);
+    if(it == nextTable.end())
+    {
+        nextTable.insert(word,cost);
+    }
+    else if(cost < it.value())
+    {
+        it.value() = cost;
+    }
+    reset();
+}
+/*
+ *@brief:   清空词格，下一次解码从头开始
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SentenceDecoder::reset()
+{
+    latticeInput.clear();
+    lattice.clear();
+}
+/*
+ *@brief:   解码拼音串。词格按字母位置逐列保存以不同词结尾的最优路径，新的拼音串与上次解码的
+ * 拼音串相同的前缀部分直接复用，只需截断并扩展后面的列，所以每增加一个字母只需计算一列，
+ * 删除字母则只需截断词格。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:输入的拼音串
+ *@return:  整句结果。拼音串无法被词表完整覆盖，或整句只由一个词构成(已在普通候选词中)时返回空
+ */
+QString SentenceDecoder::decode(const QString &pinyin)
+{
+    //计算与上次解码拼音串的公共前缀，截断词格
+    int commonLength = 0;
+    int minLength = qMin(pinyin.length(),latticeInput.length());
+    while(commonLength<minLength && pinyin.at(commonLength)==latticeInput.at(commonLength))
+    {
+        commonLength++;
+    }
+    if(lattice.isEmpty())
+    {
+        LatticeState startState;
+        startState.cost = 0.0;
+        startState.prevPos = -1;
+        startState.prevState = -1;
+        lattice.append(LatticeNode(1,startState));
+        commonLength = 0;
+    }
+    lattice.resize(commonLength+1);
+    //逐列扩展词格
+    for(int end=commonLength+1;end<=pinyin.length();end++)
+    {
+        LatticeNode node;
+        for(int start=qMax(0,end-maxKeyLength);start<end;start++)
+        {
+            const LatticeNode &startNode = lattice.at(start);
+            if(startNode.isEmpty())
+            {
+                continue;
+            }
+            QString key = pinyin.mid(start,end-start);
+            for(int i=-1;i<sharedTables.size();i++)
+            {
+                const QHash<QString,DecoderWordList> &table = (i<0)?wordTable:sharedTables.at(i);
+                QHash<QString,DecoderWordList>::const_iterator it = table.constFind(key);
+                if(it == table.constEnd())
+                {
+                    continue;
+                }
+                const DecoderWordList &wordList = it.value();
+                for(int j=0;j<wordList.size();j++)
+                {
+                    for(int k=0;k<startNode.size();k++)
+                    {
+                        LatticeState state;
+                        state.cost = startNode.at(k).cost+transitionCost(startNode.at(k).word,wordList.at(j).word)
+                                +wordList.at(j).cost;
+                        state.prevPos = start;
+                        state.prevState = k;
+                        state.word = wordList.at(j).word;
+                        insertState(node,state);
+                    }
+                }
+            }
+        }
+        lattice.append(node);
+    }
+    latticeInput = pinyin;
+    //在最后一列中选择代价最小的状态，回溯最优路径
+    int pos = pinyin.length();
+    if(pos == 0 || lattice.at(pos).isEmpty())
+    {
+        return QString();
+    }
+    int stateIndex = 0;
+    for(int i=1;i<lattice.at(pos).size();i++)
+    {
+        if(lattice.at(pos).at(i).cost < lattice.at(pos).at(stateIndex).cost)
+        {
+            stateIndex = i;
+        }
+    }
+    QString sentence;
+    int wordNum = 0;
+    while(pos > 0)
+    {
+        const LatticeState &state = lattice.at(pos).at(stateIndex);
+        sentence.prepend(state.word);
+        pos = state.prevPos;
+        stateIndex = state.prevState;
+        wordNum++;
+    }
+    if(wordNum < 2)
+    {
+        return QString();
+    }
+    return sentence;
+}
+/*
+ *@brief:   词表中词的个数
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+int SentenceDecoder::wordCount() const
+{
+    int count = 0;
+    for(int i=-1;i<sharedTables.size();i++)
+    {
+        const QHash<QString,DecoderWordList> &table = (i<0)?wordTable:sharedTables.at(i);
+        QHash<QString,DecoderWordList>::const_iterator it = table.constBegin();
+        for(;it!=table.constEnd();++it)
+        {
+            count += it.value().size();
+        }
+    }
+    return count;
+}
+/*
+ *@brief:   序列化词表，共享引用的词表合并写入，同一全拼只写代价最小的几个词。转移代价是
+ * 用户学习的结果，不写入
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   out:输出数据流
+ */
+void SentenceDecoder::saveWordTable(QDataStream &out) const
+{
+    QHash<QString,DecoderWordList> mergedTable = wordTable;
+    for(int i=0;i<sharedTables.size();i++)
+    {
+        QHash<QString,DecoderWordList>::const_iterator it = sharedTables.at(i).constBegin();
+        for(;it!=sharedTables.at(i).constEnd();++it)
+        {
+            DecoderWordList &wordList = mergedTable[it.key()];
+            for(int j=0;j<it.value().size();j++)
+            {
+                insertWord(wordList,it.value().at(j));
+            }
+        }
+    }
+    out<<quint32(mergedTable.size());
+    QHash<QString,DecoderWordList>::const_iterator it = mergedTable.constBegin();
+    for(;it!=mergedTable.constEnd();++it)
+    {
+        out<<it.key()<<quint32(it.value().size());
+        for(int i=0;i<it.value().size();i++)
+        {
+            out<<it.value().at(i).word<<it.value().at(i).cost;
+        }
+    }
+}
+/*
+ *@brief:   反序列化词表，替换原有的词表
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   in:输入数据流
+ */
+void SentenceDecoder::loadWordTable(QDataStream &in)
+{
+    clear();
+    quint32 count = 0;
+    in>>count;
+    wordTable.reserve(count);
+    for(quint32 i=0;i<count && in.status()==QDataStream::Ok;i++)
+    {
+        QString key;
+        quint32 wordNum = 0;
+        in>>key>>wordNum;
+        DecoderWordList wordList;
+        for(quint32 j=0;j<wordNum && in.status()==QDataStream::Ok;j++)
+        {
+            DecoderWord decoderWord;
+            in>>decoderWord.word>>decoderWord.cost;
+            insertWord(wordList,decoderWord);
+        }
+        wordTable.insert(key,wordList);
+        maxKeyLength = qMax(maxKeyLength,key.length());
+    }
+}
+/*
+ *@brief:   按代价由小到大插入词，代价相同时先添加的在前。词已存在时保留较小的代价，
+ * 超出保留个数的词丢弃
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   wordList:同一全拼的词列表
+ *@param:   decoderWord:要插入的词
+ */
+void SentenceDecoder::insertWord(DecoderWordList &wordList, const DecoderWord &decoderWord)
+{
+    for(int i=0;i<wordList.size();i++)
+    {
+        if(wordList.at(i).word == decoderWord.word)
+        {
+            if(wordList.at(i).cost <= decoderWord.cost)
+            {
+                return;
+            }
+            wordList.remove(i);
+            break;
+        }
+    }
+    int pos = wordList.size();
+    while(pos>0 && decoderWord.cost<wordList.at(pos-1).cost)
+    {
+        pos--;
+    }
+    if(pos >= MAXWORDSPERKEY)
+    {
+        return;
+    }
+    wordList.insert(pos,decoderWord);
+    if(wordList.size() > MAXWORDSPERKEY)
+    {
+        wordList.resize(MAXWORDSPERKEY);
+    }
+}
+/*
+ *@brief:   计算两个词之间的转移代价，默认代价加上学习到的修正值
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   prevWord:前一个词，句首为空
+ *@param:   word:后一个词
+ */
+double SentenceDecoder::transitionCost(const QString &prevWord, const QString &word) const
+{
+    if(transitionTable.isEmpty() || prevWord.isEmpty())
+    {
+        return TRANSITIONCOST;
+    }
+    QHash<QString,QHash<QString,double> >::const_iterator it = transitionTable.constFind(prevWord);
+    if(it == transitionTable.constEnd())
+    {
+        return TRANSITIONCOST;
+    }
+    return TRANSITIONCOST+it.value().value(word,0.0);
+}
+/*
+ *@brief:   向词格节点插入状态。后续的转移代价只与结尾的词有关，所以同一个词只保留代价最小的
+ * 状态；节点最多保留MAXLATTICESTATES个状态，超出时替换代价最大的
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   node:词格节点
+ *@param:   state:要插入的状态
+ */
+void SentenceDecoder::insertState(LatticeNode &node, const LatticeState &state)
+{
+    int worstIndex = -1;
+    for(int i=0;i<node.size();i++)
+    {
+        if(node.at(i).word == state.word)
+        {
+            if(state.cost < node.at(i).cost)
+            {
+                node[i] = state;
+            }
+            return;
+        }
+        if(worstIndex<0 || node.at(i).cost>node.at(worstIndex).cost)
+        {
+            worstIndex = i;
+        }
+    }
+    if(node.size() < MAXLATTICESTATES)
+    {
+        node.append(state);
+    }
+    else if(state.cost < node.at(worstIndex).cost)
+    {
+        node[worstIndex] = state;
+    }
+}
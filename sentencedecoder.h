@@ -0,0 +1,67 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  整句转换解码器，在拼音词格上用Viterbi动态规划求出代价最小的汉字句子。
+ * 词的代价由其在字典候选词中的排名决定，词与词之间的转移代价可由用户连续上屏的词学习得到。
+ */
+#ifndef SENTENCEDECODER_H
+#define SENTENCEDECODER_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QList>
+#include <QDataStream>
+
+class SentenceDecoder
+{
+public:
+    SentenceDecoder();
+
+    void clear();//清空词表及词格
+    void addWord(const QString &phrase,const QString &word,double extraCost=0.0);//向词表添加一个词
+    void addWordTables(const SentenceDecoder &other);//共享引用另一个解码器的词表
+    void addTransition(const QString &prevWord,const QString &word,double cost);//添加两个词相邻出现的转移代价
+    void reset();//清空词格，下一次解码从头开始
+    QString decode(const QString &pinyin);//解码拼音串，返回整句
+    int wordCount() const;//词表中词的个数
+    void saveWordTable(QDataStream &out) const;//序列化词表(含共享引用的词表)
+    void loadWordTable(QDataStream &in);//反序列化词表
+
+private:
+    //词表项 同一全拼按代价由小到大保留前几个词
+    struct DecoderWord
+    {
+        QString word;
+        double cost;
+    };
+    typedef QVector<DecoderWord> DecoderWordList;
+    //词格状态 以某个词结尾到达该字母位置的最优路径，转移代价取决于前一个词，所以每个位置保留多个状态
+    struct LatticeState
+    {
+        double cost;//累计代价
+        int prevPos;//最优路径上一个节点的位置
+        int prevState;//最优路径在上一个节点中的状态序号
+        QString word;//从上一个节点到本节点的词
+    };
+    typedef QVector<LatticeState> LatticeNode;
+
+    static void insertWord(DecoderWordList &wordList,const DecoderWord &decoderWord);
+    double transitionCost(const QString &prevWord,const QString &word) const;
+    static void insertState(LatticeNode &node,const LatticeState &state);
+
+    QHash<QString,DecoderWordList> wordTable;//全拼(不含分隔符)-词列表
+    QList<QHash<QString,DecoderWordList> > sharedTables;//引用的其他词表(隐式共享，不复制内容)
+    QHash<QString,QHash<QString,double> > transitionTable;//前一个词-后一个词-转移代价的修正值
+    int maxKeyLength;//词表中最长全拼的长度，限定每个节点向前查找的范围
+    QString latticeInput;//当前词格对应的拼音串
+    QVector<LatticeNode> lattice;//词格 lattice[i]对应拼音串前i个字母
+};
+
+#endif // SENTENCEDECODER_H
@@ -0,0 +1,166 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  短语表，将简短的编码映射为较长的常用文本(地址、料号、固定备注等)。所有编码和文本
+ * 分别连续存放，条目按编码排序，查询时二分查找前缀的起始位置后顺序取出，开销与条目数基本无关
+ */
+#include "snippettable.h"
+#include <QFile>
+#include <QRegExp>
+#include <QPair>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstring>
+
+/*按编码排序的比较函数*/
+static bool lessSnippetCode(const QPair<QByteArray,QString> &left,const QPair<QByteArray,QString> &right)
+{
+    return left.first < right.first;
+}
+
+bool SnippetTable::EntryLess::operator()(const Entry &entry, const QByteArray &prefix) const
+{
+    int length = qMin(int(entry.codeLength),prefix.size());
+    int result = memcmp(codes+entry.codeOffset,prefix.constData(),length);
+    return result < 0 || (result == 0 && entry.codeLength < prefix.size());
+}
+
+SnippetTable::SnippetTable()
+    :ignoredLines(0)
+{
+    resetStatistics();
+}
+/*
+ *@brief:   读短语表，每行为"编码 文本"，编码为字母(不区分大小写)，与文本之间以空白分隔，
+ * 文本为该行剩余的内容，#开头的行为注释。编码相同的多条短语按文件中的顺序显示
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:短语表文件路径
+ *@return:  文件是否打开成功
+ */
+bool SnippetTable::load(const QString &filePath)
+{
+    clear();
+    QFile snippetFile(filePath);
+    if(!snippetFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QVector<QPair<QByteArray,QString> > snippetList;
+    QRegExp lineRegExp("([A-Za-z]+)\\s+(\\S.*)");
+    int lineNumber = 0;
+    while(!snippetFile.atEnd())
+    {
+        QString lineText = QString::fromUtf8(snippetFile.readLine()).trimmed();
+        lineNumber++;
+        if(lineNumber == 1 && lineText.startsWith(QChar(0xFEFF)))//UTF-8 BOM
+        {
+            lineText.remove(0,1);
+        }
+        if(lineText.isEmpty() || lineText.startsWith('#'))
+        {
+            continue;
+        }
+        if(!lineRegExp.exactMatch(lineText) || lineRegExp.cap(1).length() > 0xFFFF
+                || lineRegExp.cap(2).length() > 0xFFFF)
+        {
+            ignoredLines++;//格式错误的行忽略，个数通过ignoredLineCount()获取
+            continue;
+        }
+        snippetList.append(qMakePair(lineRegExp.cap(1).toLower().toLatin1(),lineRegExp.cap(2)));
+    }
+    std::stable_sort(snippetList.begin(),snippetList.end(),lessSnippetCode);
+    //编码和文本连续存放，条目只记录偏移和长度
+    entries.reserve(snippetList.size());
+    for(int i=0;i<snippetList.size();i++)
+    {
+        Entry entry;
+        entry.codeOffset = codeData.size();
+        entry.codeLength = snippetList.at(i).first.size();
+        entry.textOffset = textData.size();
+        entry.textLength = snippetList.at(i).second.length();
+        codeData.append(snippetList.at(i).first);
+        textData.append(snippetList.at(i).second);
+        entries.append(entry);
+    }
+    codeData.squeeze();
+    textData.squeeze();
+    return true;
+}
+
+void SnippetTable::clear()
+{
+    ignoredLines = 0;
+    codeData.clear();
+    textData.clear();
+    entries.clear();
+}
+
+bool SnippetTable::isEmpty() const
+{
+    return entries.isEmpty();
+}
+
+int SnippetTable::snippetCount() const
+{
+    return entries.size();
+}
+
+int SnippetTable::ignoredLineCount() const
+{
+    return ignoredLines;
+}
+
+int SnippetTable::memoryBytes() const
+{
+    return codeData.size()+textData.size()*int(sizeof(QChar))+entries.size()*int(sizeof(Entry));
+}
+/*
+ *@brief:   查询编码以prefix开头的短语。条目按编码排序，二分查找第一个不小于前缀的条目，
+ * 之后编码以前缀开头的条目是连续的，完全匹配的编码最短，排在最前面
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   prefix:已输入的编码
+ *@param:   maxResults:最多返回的短语个数
+ *@return:  短语文本列表
+ */
+QStringList SnippetTable::match(const QString &prefix, int maxResults)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QStringList result;
+    QByteArray lowerPrefix = prefix.toLower().toLatin1();
+    if(!lowerPrefix.isEmpty() && !entries.isEmpty())
+    {
+        EntryLess entryLess = {codeData.constData()};
+        QVector<Entry>::const_iterator it = std::lower_bound(entries.constBegin(),entries.constEnd(),
+                                                             lowerPrefix,entryLess);
+        for(;it!=entries.constEnd() && result.size()<maxResults;++it)
+        {
+            if(it->codeLength < lowerPrefix.size()
+                    || memcmp(codeData.constData()+it->codeOffset,lowerPrefix.constData(),lowerPrefix.size()) != 0)
+            {
+                break;
+            }
+            result.append(textData.mid(it->textOffset,it->textLength));
+        }
+    }
+    stats.latency.add(timer.nsecsElapsed());
+    return result;
+}
+
+SnippetTable::Statistics SnippetTable::statistics() const
+{
+    return stats;
+}
+
+void SnippetTable::resetStatistics()
+{
+    stats.latency.clear();
+}
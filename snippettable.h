@@ -0,0 +1,66 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  短语表，将简短的编码映射为较长的常用文本(地址、料号、固定备注等)。所有编码和文本
+ * 分别连续存放，条目按编码排序，查询时二分查找前缀的起始位置后顺序取出，开销与条目数基本无关
+ */
+#ifndef SNIPPETTABLE_H
+#define SNIPPETTABLE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include "latencyhistogram.h"
+
+class SnippetTable
+{
+public:
+    //查询开销统计
+    struct Statistics
+    {
+        LatencyHistogram latency;//每次查询的耗时分布
+    };
+
+    SnippetTable();
+
+    bool load(const QString &filePath);//读短语表
+    void clear();
+    bool isEmpty() const;
+    int snippetCount() const;//短语个数
+    int ignoredLineCount() const;//读短语表时忽略的格式错误的行数
+    int memoryBytes() const;//索引及文本占用的内存
+    QStringList match(const QString &prefix,int maxResults);//编码以prefix开头的短语，完全匹配的在前
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    //短语条目 编码和文本以偏移和长度引用连续存放的数据
+    struct Entry
+    {
+        quint32 codeOffset;
+        quint32 textOffset;
+        quint16 codeLength;
+        quint16 textLength;
+    };
+    //按编码比较条目与前缀，用于二分查找
+    struct EntryLess
+    {
+        const char *codes;
+        bool operator()(const Entry &entry,const QByteArray &prefix) const;
+    };
+
+    QByteArray codeData;//所有编码(小写字母)
+    QString textData;//所有文本
+    QVector<Entry> entries;//按编码排序，编码相同的保持文件中的顺序
+    int ignoredLines;//读短语表时忽略的行数
+    Statistics stats;
+};
+
+#endif // SNIPPETTABLE_H
@@ -12,13 +12,163 @@
  */
 #include "softkeyboard.h"
 #include <QBoxLayout>
+#include <QGridLayout>
+#include <QInputMethodEvent>
+#include <QTextCharFormat>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QHash>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWeakPointer>
+#include <QtConcurrentRun>
+#include "pinyinsyllable.h"
 
 #define PINYINFILEPATH  "./ChinesePinyin"
+#define COMPRESSEDPINYINFILEPATH "./ChinesePinyin.pyz"   //分块压缩的拼音字典，存在时优先使用
+#define DICTRELOADDELAY 1000    //字典文件改变后延时重新加载的时间(ms)
+#define USERDICTPATH    "./ChinesePinyin-User"  //用户词典路径，实际文件为.log日志和.dat索引
+#define SYSTEMLAYERNAME "system"    //系统字典层名称
+#define USERLAYERNAME   "user"      //用户字典层名称
+#define USERLAYERRANKBIAS -1        //用户字典层的排序偏移，排名相同时用户学习的词组优先
+#define MAXLEARNPHRASELENGTH 4  //组词学习的最大词组长度
+#define LEARNEDPHRASECOST -0.3  //学习的词组在整句解码中的额外代价，使其优先于字典词
+#define LEARNEDTRANSITIONCOST -0.5  //连续选择的两个词在整句解码中的转移代价修正值
+#define MAXLEARNEDTRANSITIONS 256   //保留的相邻词对个数，超出时丢弃最早学习的
+#define MINCORRECTIONLENGTH 3   //拼音纠错的最小拼音长度，过短的拼音纠错结果没有意义
+#define MAXCORRECTIONKEYS   8   //拼音纠错最多采用的拼音个数
+#define ENGLISHWORDSPATH    "./EnglishWords"    //英文词频表，不存在时不进行英文补全
+#define MAXENGLISHCANDIDATES 18 //英文补全及联想最多的候选单词个数
+#define SNIPPETFILEPATH     "./ChinesePinyin-Snippets"  //短语表，不存在时不显示短语
+#define MAXSNIPPETCANDIDATES 5  //候选条中最多显示的短语个数
+#define MAXT9SPELLINGS      12  //九宫格数字串最多对应的拼音个数
+#define STROKEFILEPATH      "./ChineseStroke"   //笔画表，不存在时不能使用笔画输入
+#define MAXSTROKECANDIDATES 256 //笔画输入最多的候选字词个数
+#define WARMUPCANDIDATENUM  6   //每个单字母拼音预先渲染的常用候选字个数
+#define CANDIDATEFETCHNUM   32  //候选条每次获取的候选词个数
+#define KEYBURSTINTERVAL    16  //实体键盘连续按键合并匹配的时间窗口(ms)，约为一帧
+#define STRINGHEADERBYTES   24  //字符串数据头的估算大小，用于候选词内存统计
+
+/*
+ *@brief:   共享指针的空删除器，用于引用由键盘管理生命周期的字典(如用户词典)
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static void keepDictionaryIndex(const DictionaryIndex *)
+{
+}
+
+/*
+ *@brief:   加载字典文件，根据文件标识区分分块压缩字典和文本字典。该函数不涉及界面操作，
+ * 可以在后台线程中调用
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:字典文件路径
+ *@return:  加载完成的字典，文件打开失败时为空
+ */
+static QSharedPointer<const DictionaryIndex> loadPinyinDictionary(QString filePath)
+{
+    if(CompressedDictionary::isCompressedFile(filePath))
+    {
+        CompressedDictionary *dictionary = new CompressedDictionary();
+        if(!dictionary->open(filePath))
+        {
+            delete dictionary;
+            return QSharedPointer<const DictionaryIndex>();
+        }
+        return QSharedPointer<const DictionaryIndex>(dictionary);
+    }
+    PinyinDictionary *dictionary = new PinyinDictionary();
+    if(!dictionary->load(filePath))
+    {
+        delete dictionary;
+        return QSharedPointer<const DictionaryIndex>();
+    }
+    return QSharedPointer<const DictionaryIndex>(dictionary);
+}
+
+/*进程内共享的字典登记表，键为字典文件的绝对路径。多个键盘加载同一文件时共用一份只读字典。
+登记表的互斥锁只在加载字典时使用，不在查询路径上；文本字典的查询不加锁，压缩字典的查询
+仍需通过页面缓存的互斥锁*/
+struct SharedDictionaryEntry
+{
+    QWeakPointer<const DictionaryIndex> index;//最后一个键盘释放后字典自动删除
+    QDateTime lastModified;//加载时文件的修改时间
+    qint64 fileSize;//加载时文件的大小
+};
+static QMutex sharedDictionaryMutex;
+static QHash<QString,SharedDictionaryEntry> sharedDictionaries;
+
+/*
+ *@brief:   获取登记表中与文件当前版本一致的字典，没有时返回空。已被所有键盘释放的字典从登记表移除
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   fileInfo:字典文件信息
+ */
+static QSharedPointer<const DictionaryIndex> findSharedDictionary(const QFileInfo &fileInfo)
+{
+    QHash<QString,SharedDictionaryEntry>::iterator it = sharedDictionaries.find(fileInfo.absoluteFilePath());
+    if(it == sharedDictionaries.end())
+    {
+        return QSharedPointer<const DictionaryIndex>();
+    }
+    QSharedPointer<const DictionaryIndex> dictionary = it->index.toStrongRef();
+    if(dictionary.isNull())
+    {
+        sharedDictionaries.erase(it);
+        return dictionary;
+    }
+    if(it->lastModified != fileInfo.lastModified() || it->fileSize != fileInfo.size())
+    {
+        return QSharedPointer<const DictionaryIndex>();
+    }
+    return dictionary;
+}
+/*
+ *@brief:   加载共享的字典。同一文件已被其他键盘加载且文件没有改变时直接共用，否则加载后登记。
+ * 两个键盘同时加载同一版本时，后完成的使用先登记的字典，丢弃自己加载的。该函数可以在后台线程中调用
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:字典文件路径
+ *@return:  字典，文件打开失败时为空
+ */
+static QSharedPointer<const DictionaryIndex> loadSharedDictionary(QString filePath)
+{
+    QFileInfo fileInfo(filePath);//加载前记录文件版本，加载期间文件改变时下次会重新加载
+    QSharedPointer<const DictionaryIndex> dictionary;
+    {
+        QMutexLocker locker(&sharedDictionaryMutex);
+        dictionary = findSharedDictionary(fileInfo);
+    }
+    if(!dictionary.isNull())
+    {
+        return dictionary;
+    }
+    dictionary = loadPinyinDictionary(filePath);
+    if(dictionary.isNull())
+    {
+        return dictionary;
+    }
+    QMutexLocker locker(&sharedDictionaryMutex);
+    QSharedPointer<const DictionaryIndex> registered = findSharedDictionary(fileInfo);
+    if(!registered.isNull())
+    {
+        return registered;
+    }
+    SharedDictionaryEntry entry;
+    entry.index = dictionary;
+    entry.lastModified = fileInfo.lastModified();
+    entry.fileSize = fileInfo.size();
+    sharedDictionaries.insert(fileInfo.absoluteFilePath(),entry);
+    return dictionary;
+}
 
 SoftKeyboard::SoftKeyboard(QWidget *parent) :
-    QWidget(parent),cursorGlobalPos(0,0),isMousePress(false)
+    QWidget(parent),isSentenceMode(false),isT9Mode(false),isStrokeMode(false),isTypoCorrection(false),cursorGlobalPos(0,0),isMousePress(false)
 {
     /*设置键盘整体界面的最小大小，因为整体界面添加布局，布局的默认约束为SetDefaultConstraint
     这种约束只针对顶级窗口，会设置顶级窗口的最小大小为布局的minimumsize，而布局的最小大小是由内部的
@@ -28,11 +178,26 @@ SoftKeyboard::SoftKeyboard(QWidget *parent) :
     this->resize(800,480);//默认大小
     this->setWindowFlags(Qt::FramelessWindowHint);//无边框
     this->setWindowModality(Qt::ApplicationModal);//应用模态
+    //实体键盘输入 一个时间窗口内的连续按键只匹配最终的拼音
+    isPhysicalKeyboard = true;
+    pinyinMatchTimer = new QTimer(this);
+    pinyinMatchTimer->setSingleShot(true);
+    pinyinMatchTimer->setInterval(KEYBURSTINTERVAL);
+    connect(pinyinMatchTimer,SIGNAL(timeout()),this,SLOT(pinyinMatchSlot()));
+    //运行统计日志 设置间隔后才启动
+    statisticsLogTimer = new QTimer(this);
+    connect(statisticsLogTimer,SIGNAL(timeout()),this,SLOT(statisticsLogSlot()));
     //初始化ui显示
     this->initStyleSheet();
     this->initInputBufferArea();
     this->initFunctionAndCandidateArea();
     this->initKeysArea();
+    this->initT9KeysArea();
+    this->initStrokeKeysArea();
+    touchKeyInput = new TouchKeyInput(this,this);
+    touchKeyInput->addKeyArea(keysArea);
+    touchKeyInput->addKeyArea(t9KeysArea);
+    touchKeyInput->addKeyArea(strokeKeysArea);
     this->selectKeyboardStyle(0);//选择皮肤
     this->setMoveEnabled();
     //整体垂直布局
@@ -42,9 +207,28 @@ SoftKeyboard::SoftKeyboard(QWidget *parent) :
     globalVLayout->addWidget(inputBufferArea,1);
     globalVLayout->addWidget(functionAndCandidateArea,1);
     globalVLayout->addWidget(keysArea,5);
+    globalVLayout->addWidget(t9KeysArea,5);
+    globalVLayout->addWidget(strokeKeysArea,5);
 
     readDictionary();//读拼音字典
-    showInputBufferArea();
+    initDictionaryReload();
+    //用户词典 作为一层字典参与查询，学习的词组同样参与整句解码
+    userDictionary = new UserDictionary(USERDICTPATH,this);
+    layeredDictionary.setLayer(USERLAYERNAME,QSharedPointer<const DictionaryIndex>(userDictionary,keepDictionaryIndex),
+                               USERLAYERRANKBIAS,QString(),true);
+    resetSentenceDecoder();
+    phraseChainEdit = NULL;
+    t9SpellingIndex = 0;
+    fetchedCandidateCount = 0;
+    loadEnglishWords(ENGLISHWORDSPATH);
+    loadSnippets(SNIPPETFILEPATH);
+    /*不常用的候选区和输入缓存区在空闲时逐个创建，不占用构造及首次显示的时间。输入缓存区默认显示，
+    首次显示前未指定输入编辑框时在showEvent中显示*/
+    lazyInitTimer = new QTimer(this);
+    lazyInitTimer->setSingleShot(true);
+    lazyInitTimer->setInterval(0);
+    connect(lazyInitTimer,SIGNAL(timeout()),this,SLOT(lazyInitSlot()));
+    lazyInitTimer->start();
 }
 
 SoftKeyboard::~SoftKeyboard()
@@ -67,8 +251,13 @@ void SoftKeyboard::selectKeyboardStyle(int num)
     skinNum = num;
     //设置按键区域的样式
     keysArea->setStyleSheet(keysAreaStyle.at(num));
+    t9KeysArea->setStyleSheet(keysAreaStyle.at(num));
+    strokeKeysArea->setStyleSheet(keysAreaStyle.at(num));
     //设置功能和候选区区域的样式
     functionAndCandidateArea->setStyleSheet(functionAndCandidateAreaStyle.at(num));
+    //皮肤改变后文字的颜色、字体随之改变，原有的文字图片不再使用
+    textPixmapCache.clear();
+    QTimer::singleShot(0,this,SLOT(warmTextCacheSlot()));
 }
 /*
  *@brief:   设置无边框窗口是否可以移动
@@ -92,11 +281,13 @@ void SoftKeyboard::setMoveEnabled(bool moveEnabled)
  */
 void SoftKeyboard::showInputBufferArea(QString inputTitle, QString inputContent)
 {
+    ensureInputBufferArea();
     inputBufferArea->setVisible(true);
     inputTitleLabel->setText(inputTitle);
     inputContentEdit->setText(inputContent);
     inputContentEdit->setFocus();
     currentLineEdit = inputContentEdit;//将内置编辑框设置为当前编辑框
+    setInputTarget(NULL);
 }
 /*
  *@brief:   隐藏输入缓存区
@@ -110,612 +301,1834 @@ void SoftKeyboard::hideInputBufferArea(QLineEdit *currLineEdit)
 {
     inputBufferArea->setVisible(false);
     currentLineEdit = currLineEdit;
+    setInputTarget(NULL);
 }
 /*
- *@brief:   鼠标按下事件处理
+ *@brief:   设置组合输入的目标部件，可以是任意支持输入法的部件(设置了Qt::WA_InputMethodEnabled，
+ * 如QLineEdit、QTextEdit、QPlainTextEdit等)。设置后拼音作为预编辑文本直接显示在目标部件中，
+ * 提交的文字、删除等操作都通过QInputMethodEvent发送给目标部件，候选区不再显示拼音，也就不需要
+ * 在每次按键时重新计算候选字母框的宽度。传入NULL时恢复为向编辑框直接插入文字
  *@author:  缪庆瑞
- *@date:    2019.7.5
+ *@date:    2026.10.19
+ *@param:   target:组合输入的目标部件
  */
-void SoftKeyboard::mousePressEvent(QMouseEvent *event)
+void SoftKeyboard::setInputTarget(QWidget *target)
 {
-    if(event->button()==Qt::LeftButton)//左键按下
+    if(inputTarget && inputTarget != target)
     {
-        isMousePress = true;
-        cursorGlobalPos =event->globalPos();//获取鼠标按下时的全局位置
-        //qDebug()<<"mouse press:"<<cursorGlobalPos;
+        updatePreedit(QString());//清除原目标部件中的预编辑文本
+    }
+    inputTarget = target;
+    if(target)
+    {
+        inputBufferArea->setVisible(false);
+    }
+    if(candidateLetter)
+    {
+        candidateLetter->setVisible(!target);
+        candidateLetterChangedSlot(candidateLetter->text());//正在输入的拼音转移到新的显示位置
     }
+    updateKeyEventSource();
 }
 /*
- *@brief:   鼠标移动事件处理
+ *@brief:   设置实体键盘(USB键盘、按键板)输入使能。使能后键盘显示时，当前输入部件收到的按键
+ * 与屏幕按键走相同的中文输入流程：字母组成拼音，空格选择第一个候选词，数字1-9选择候选条中
+ * 可见的第n个候选词，退格删除拼音，回车输入拼音字母，Esc取消输入
  *@author:  缪庆瑞
- *@date:    2019.7.5
+ *@date:    2026.10.19
+ *@param:   enabled:实体键盘输入使能
  */
-void SoftKeyboard::mouseMoveEvent(QMouseEvent *event)
+void SoftKeyboard::setPhysicalKeyboardEnabled(bool enabled)
 {
-    //不可以用event.button()==Qt::LeftButton来判断，因为在鼠标移动事件里该方法一直返回Qt::NoButton
-    if(event->buttons()&Qt::LeftButton && isMousePress && isMoveEnabled)
+    isPhysicalKeyboard = enabled;
+    if(!enabled)
     {
-        //qDebug()<<"mouse move:"<<event->globalPos();
-        QPoint position = this->pos() + event->globalPos() - cursorGlobalPos;
-        move(position.x(), position.y());
-        cursorGlobalPos = event->globalPos();
+        flushPinyinMatch();
     }
+    updateKeyEventSource();
 }
 /*
- *@brief:   鼠标释放事件处理
+ *@brief:   设置整句输入模式使能
+ * 使能后，中文输入时会将完整的拼音串解码为最可能的汉字句子，作为第一个候选词显示，
+ * 避免输入长句时需要逐词选择
  *@author:  缪庆瑞
- *@date:    2019.7.5
+ *@date:    2026.10.19
+ *@param:   enabled:整句模式使能
  */
-void SoftKeyboard::mouseReleaseEvent(QMouseEvent *event)
+void SoftKeyboard::setSentenceModeEnabled(bool enabled)
 {
-    if(event->button()==Qt::LeftButton)//左键按下
-    {
-        isMousePress = false;
-        //qDebug()<<"mouse release:";
-    }
+    isSentenceMode = enabled;
+    resetSentenceDecoder();
 }
 /*
- *@brief:   初始化样式表，即用于界面皮肤选择
+ *@brief:   设置模糊音规则。模糊音在查询时展开输入的拼音，不会增加拼音哈希表的键值对
  *@author:  缪庆瑞
- *@date:    2020.05.09
+ *@date:    2026.10.19
+ *@param:   mask:模糊音规则，FuzzyPinyin::FuzzyFlag按位组合，0表示关闭
+ *@param:   maxVariants:每次查询最多展开的拼音个数，限定每次按键的额外开销
  */
-void SoftKeyboard::initStyleSheet()
+void SoftKeyboard::setFuzzyPinyin(int mask, int maxVariants)
 {
-    /*皮肤1:雅黑*/
-    //按键区域样式
-    keysAreaStyle.append(
-                ".QWidget{background-color:#1E1E1E;}"
-                "QToolButton{background-color:#4E4E4E;color:#E6E6E6;border-radius:4px;}"
-                "QToolButton#specialKeyStyle{background-color:#2D2D2D;border-radius:2px;}");
-    //功能和候选区区域样式 目前与按键区域样式一致
-    functionAndCandidateAreaStyle.append(
-                "QWidget{background-color:#1E1E1E;color:#E6E6E6;}"
-                "QToolButton{border-style:none;}"
-                "QToolButton#pageBtn{font-weight:bold;}"
-                "QToolButton#pageBtn:disabled{color:#6c97b4;}"
-                "QLineEdit{background-color:#4E4E4E;}");
-    /*皮肤2:简白*/
-    keysAreaStyle.append(
-                ".QWidget{background-color:#D8D8D8;}"
-                "QToolButton{background-color:#FFFFFF;color:black;border-radius:6px;}"
-                "QToolButton#specialKeyStyle{background-color:#EBEBEB;border-radius:6px;}");
-    functionAndCandidateAreaStyle.append(
-                "QWidget{background-color:#D8D8D8;color:black;}"
-                "QToolButton{border-style:none;}"
-                "QToolButton#pageBtn{font-weight:bold;}"
-                "QToolButton#pageBtn:disabled{color:#6c97b4;}"
-                "QLineEdit{background-color:white;}");
-    /*皮肤3:魅紫*/
-    keysAreaStyle.append(
-                ".QWidget{background-color:#190724;}"
-                "QToolButton{background-color:#272A5E;color:#68CBF2;border-radius:4px;}"
-                "QToolButton#specialKeyStyle{background-color:#241D48;border-radius:2px;}");
-    functionAndCandidateAreaStyle.append(
-                "QWidget{background-color:#190724;color:#68CBF2;}"
-                "QToolButton{border-style:none;}"
-                "QToolButton#pageBtn{font-weight:bold;}"
-                "QToolButton#pageBtn:disabled{color:#6c97b4;}"
-                "QLineEdit{background-color:#272A5E;}");
+    fuzzyPinyin.setMask(mask);
+    fuzzyPinyin.setMaxVariants(maxVariants);
+    fuzzyPinyin.resetStatistics();
 }
 /*
- *@brief:   初始化软键盘的数字字母(字符)按键
+ *@brief:   获取模糊音查询的开销统计
  *@author:  缪庆瑞
- *@date:    2020.05.09
+ *@date:    2026.10.19
  */
-void SoftKeyboard::initNumberLetterBtn()
+FuzzyPinyin::Statistics SoftKeyboard::fuzzyPinyinStatistics() const
 {
-    //以下36个按键，仅作为普通输入，无其他功能，所以连接一个槽函数
-    for(int i=0;i<36;i++)//为10个数字，26个字母按键申请空间,连接信号与槽
+    return fuzzyPinyin.statistics();
+}
+/*
+ *@brief:   设置拼音纠错使能。纠错在拼音字典键的字典树上按编辑距离搜索，相邻按键的误按代价
+ * 较小，纠错得到的候选词排在精确匹配之后。字典树在首次使能时于后台构建。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   enabled:纠错使能
+ *@param:   maxDistance:最大编辑距离(1~2)
+ */
+void SoftKeyboard::setTypoCorrectionEnabled(bool enabled, int maxDistance)
+{
+    isTypoCorrection = enabled;
+    pinyinCorrector.setMaxDistance(maxDistance);
+    if(enabled && pinyinCorrector.isEmpty())
     {
-        numberLetterBtn[i] = new QToolButton();
-        numberLetterBtn[i]->setToolButtonStyle(Qt::ToolButtonTextOnly);
-        numberLetterBtn[i]->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-        connect(numberLetterBtn[i],SIGNAL(clicked()),this,SLOT(numberLetterBtnSlot()));
+        //按键区字母布局:第二排10个，第三排9个(两侧留有边距)，第四排7个(左侧为大小写按键)
+        QStringList letterList = letterLowList();
+        QStringList rowList;
+        rowList<<QStringList(letterList.mid(10,10)).join("")
+               <<QStringList(letterList.mid(20,9)).join("")
+               <<QStringList(letterList.mid(29,7)).join("");
+        QList<double> offsetList;
+        offsetList<<0.0<<0.5<<1.5;
+        pinyinCorrector.setKeyboardRows(rowList,offsetList);
+        buildCorrectorAsync();//字典树较大，在后台构建
     }
 }
 /*
- *@brief:   初始化软键盘的特殊功能按键,诸如大小写切换/删除等
+ *@brief:   获取拼音纠错的开销统计
  *@author:  缪庆瑞
- *@date:    2020.05.09
+ *@date:    2026.10.19
  */
-void SoftKeyboard::initSpecialBtn()
+PinyinCorrector::Statistics SoftKeyboard::typoCorrectionStatistics() const
 {
-    upperOrLowerBtn = new QToolButton();
-    upperOrLowerBtn->setObjectName("specialKeyStyle");
-    upperOrLowerBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    upperOrLowerBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-    upperOrLowerBtn->setText("A/a");
-    connect(upperOrLowerBtn,SIGNAL(clicked()),this,SLOT(changeUpperLowerSlot()));
-
-    deleteBtn = new QToolButton();
-    deleteBtn->setObjectName("specialKeyStyle");
-    deleteBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    deleteBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-    deleteBtn->setText("del");
-    deleteBtn->setAutoRepeatDelay(300);
-    deleteBtn->setAutoRepeatInterval(60);
-    deleteBtn->setAutoRepeat(true);//启用自动重复功能，实现长按连续动作
-    connect(deleteBtn,SIGNAL(clicked(bool)),this,SLOT(deleteTextSlot()));
-
-    skinBtn = new QToolButton();
-    skinBtn->setObjectName("specialKeyStyle");
-    skinBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    skinBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-    skinBtn->setText("skin");
-    connect(skinBtn,SIGNAL(clicked()),this,SLOT(changeSkinSlot()));
-
-    letterOrSymbolBtn = new QToolButton();
-    letterOrSymbolBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    letterOrSymbolBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-    letterOrSymbolBtn->setText("abc");
-    connect(letterOrSymbolBtn,SIGNAL(clicked()),this,SLOT(changeLetterSymbolSlot()));
-
-    commaBtn = new QToolButton();
-    commaBtn->setMinimumSize(36,16);//设置最小大小，主要是为了清掉布局的默认最佳大小
-    commaBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    commaBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-    commaBtn->setText(",");
-    connect(commaBtn,SIGNAL(clicked()),this,SLOT(numberLetterBtnSlot()));
-
-    spaceBtn = new QToolButton();
-    spaceBtn->setText(" ");
-    spaceBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    spaceBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-    connect(spaceBtn,SIGNAL(clicked()),this,SLOT(spaceSlot()));
-
-    periodBtn = new QToolButton();
-    periodBtn->setMinimumSize(36,16);
-    periodBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    periodBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-    periodBtn->setText(".");
-    connect(periodBtn,SIGNAL(clicked()),this,SLOT(numberLetterBtnSlot()));
-
-    chOrEnBtn = new QToolButton();
-    chOrEnBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    chOrEnBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-    chOrEnBtn->setText("CH");
-    isENInput = false;//初始化为中文输入
-    connect(chOrEnBtn,SIGNAL(clicked()),this,SLOT(changeChEnSlot()));
-
-    enterBtn = new QToolButton();
-    enterBtn->setObjectName("specialKeyStyle");
-    enterBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    enterBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-    enterBtn->setText("  Enter  ");
-    connect(enterBtn,SIGNAL(clicked()),this,SLOT(enterSlot()));
+    return pinyinCorrector.statistics();
 }
 /*
- *@brief:   设置小写字母显示
+ *@brief:   加载字典文件(文本格式同拼音字典，也可以是分块压缩字典)作为一层字典，如设备名称、地名等领域词汇。
+ * 同名的层已存在时替换。字典文件同样会被监视，改变后自动重新加载。
  *@author:  缪庆瑞
- *@date:    2020.05.09
+ *@date:    2026.10.19
+ *@param:   name:层名称
+ *@param:   filePath:字典文件路径
+ *@param:   rankBias:排序偏移，加到该层候选词的排名上，负值使该层的词更靠前
+ *@return:  字典文件是否打开成功
  */
-void SoftKeyboard::setLetterLow()
+bool SoftKeyboard::addDictionaryLayer(const QString &name, const QString &filePath, int rankBias)
 {
-    this->isLetterInput = true;
-    this->isLetterLower = true;
-    this->letterOrSymbolBtn->setText("abc");
-    QStringList letterLowList;
-    letterLowList<<"1"<<"2"<<"3"<<"4"<<"5"<<"6"<<"7"<<"8"<<"9"<<"0"
-                 <<"q"<<"w"<<"e"<<"r"<<"t"<<"y"<<"u"<<"i"<<"o"<<"p"
-                 <<"a"<<"s"<<"d"<<"f"<<"g"<<"h"<<"j"<<"k"<<"l"
-                 <<"z"<<"x"<<"c"<<"v"<<"b"<<"n"<<"m";
-    for(int i=0;i<36;i++)
+    QSharedPointer<const DictionaryIndex> dictionary = loadSharedDictionary(filePath);
+    if(dictionary.isNull())
     {
-        numberLetterBtn[i]->setText(letterLowList.at(i));
+        qDebug()<<"addDictionaryLayer():Failed to open"<<filePath;
+        return false;
+    }
+    layeredDictionary.setLayer(name,dictionary,rankBias,filePath);
+    if(!dictionaryWatcher->files().contains(filePath))
+    {
+        dictionaryWatcher->addPath(filePath);
     }
+    dictionaryLayersChanged();
+    return true;
 }
 /*
- *@brief:   设置大写字母显示
+ *@brief:   添加已有的字典作为一层字典，多个键盘可以共享同一份只读字典
  *@author:  缪庆瑞
- *@date:    2020.05.09
+ *@date:    2026.10.19
+ *@param:   name:层名称
+ *@param:   index:字典索引
+ *@param:   rankBias:排序偏移
  */
-void SoftKeyboard::setLetterUpper()
+void SoftKeyboard::addDictionaryLayer(const QString &name, QSharedPointer<const DictionaryIndex> index, int rankBias)
 {
-    this->isLetterInput = true;
-    this->isLetterLower = false;
-    this->letterOrSymbolBtn->setText("abc");
-    QStringList letterUpperList;
-    letterUpperList<<"1"<<"2"<<"3"<<"4"<<"5"<<"6"<<"7"<<"8"<<"9"<<"0"
-                   <<"Q"<<"W"<<"E"<<"R"<<"T"<<"Y"<<"U"<<"I"<<"O"<<"P"
-                   <<"A"<<"S"<<"D"<<"F"<<"G"<<"H"<<"J"<<"K"<<"L"
-                   <<"Z"<<"X"<<"C"<<"V"<<"B"<<"N"<<"M";
-    for(int i=0;i<36;i++)
+    if(index.isNull())
     {
-        numberLetterBtn[i]->setText(letterUpperList.at(i));
+        return;
     }
+    layeredDictionary.setLayer(name,index,rankBias);
+    dictionaryLayersChanged();
 }
 /*
- *@brief:   设置符号显示，包含所有可输入符号(英文状态)
+ *@brief:   卸载一层字典，其他共享该字典的键盘不受影响
  *@author:  缪庆瑞
- *@date:    2020.05.09
+ *@date:    2026.10.19
+ *@param:   name:层名称
+ *@return:  该层是否存在
  */
-void SoftKeyboard::setSymbolsEN()
+bool SoftKeyboard::removeDictionaryLayer(const QString &name)
 {
-    this->isLetterInput = false;
-    this->letterOrSymbolBtn->setText(":;?");
-    QStringList symbolsENList;
-    symbolsENList<<"!"<<"@"<<"#"<<"$"<<"%"<<"^"<<"&&"<<"*"<<"("<<")"
-               <<"["<<"]"<<"{"<<"}"<<"<"<<">"<<"+"<<"-"<<"_"<<"="
-               <<"`"<<"~"<<"|"<<"\\"<<"'"<<"\""<<":"<<";"<<"?"
-               <<"/"<<"..."<<"---"<<"www."<<".com"<<".cn"<<".net";
-    for(int i=0;i<36;i++)
+    QStringList oldPathList = layeredDictionary.layerFilePaths();
+    if(!layeredDictionary.removeLayer(name))
     {
-        numberLetterBtn[i]->setText(symbolsENList.at(i));
+        return false;
     }
+    //不再被任何层使用的字典文件停止监视，并取消等待中的重新加载
+    QStringList pathList = layeredDictionary.layerFilePaths();
+    for(int i=0;i<oldPathList.size();i++)
+    {
+        if(!pathList.contains(oldPathList.at(i)))
+        {
+            dictionaryWatcher->removePath(oldPathList.at(i));
+            pendingReloadPaths.removeAll(oldPathList.at(i));
+        }
+    }
+    dictionaryLayersChanged();
+    return true;
 }
 /*
- *@brief:   设置符号显示，包含所有可输入符号(中文状态)
+ *@brief:   获取一层字典，可以共享给其他键盘使用。用户字典属于本键盘，随键盘或用户词典路径改变而释放，不应共享
  *@author:  缪庆瑞
- *@date:    2020.05.09
+ *@date:    2026.10.19
+ *@param:   name:层名称，系统字典为"system"，用户字典为"user"
  */
-void SoftKeyboard::setSymbolsCH()
+QSharedPointer<const DictionaryIndex> SoftKeyboard::dictionaryLayer(const QString &name) const
 {
-    this->isLetterInput = false;
-    this->letterOrSymbolBtn->setText(":;?");
-    QStringList symbolsCHList;
-    //为了兼容Qt4  中文状态下特有的字符用fromUtf8转换,避免使用tr()影响国际化翻译
-    symbolsCHList<<QString::fromUtf8("！")<<"@"<<"#"<<QString::fromUtf8("￥")<<"%"<<QString::fromUtf8("…")<<"&&"<<"*"<<QString::fromUtf8("（")<<QString::fromUtf8("）")
-            <<QString::fromUtf8("【")<<QString::fromUtf8("】")<<"{"<<"}"<<QString::fromUtf8("《")<<QString::fromUtf8("》")<<"+"<<"-"<<QString::fromUtf8("—")<<"="
-            <<"."<<"~"<<"|"<<QString::fromUtf8("、")<<QString::fromUtf8("’")<<QString::fromUtf8("‘")<<QString::fromUtf8("“")<<QString::fromUtf8("”")<<QString::fromUtf8("：")
-            <<QString::fromUtf8("；")<<QString::fromUtf8("？")<<QString::fromUtf8("♀")<<QString::fromUtf8("℃")<<QString::fromUtf8("★")<<QString::fromUtf8("→")<<QString::fromUtf8("←");
-    for(int i=0;i<36;i++)
-    {
-        numberLetterBtn[i]->setText(symbolsCHList.at(i));
-    }
+    return layeredDictionary.layer(name);
 }
 /*
- *@brief:   初始化键盘输入缓存区，临时存放显示输入的内容
+ *@brief:   设置用户词典路径。同时显示的多个键盘(如每个操作工位一个)共用系统字典，用户学习的
+ * 词频及词组按工位分开记录，各键盘应使用不同的用户词典路径
  *@author:  缪庆瑞
- *@date:    2019.7.5
+ *@date:    2026.10.19
+ *@param:   filePath:用户词典路径，实际文件为.log日志和.dat索引
  */
-void SoftKeyboard::initInputBufferArea()
+void SoftKeyboard::setUserDictionaryPath(const QString &filePath)
 {
-    //输入缓存标题
-    inputTitleLabel = new QLabel();
-    inputTitleLabel->setSizePolicy(QSizePolicy::Fixed,QSizePolicy::Preferred);
-    //输入缓存内容编辑框
-    inputContentEdit = new QLineEdit();
-    inputContentEdit->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
-    currentLineEdit = inputContentEdit;//默认将内置编辑框设置为当前编辑框
-    //输入缓存部件
-    inputBufferWidget = new QWidget();
-    //inputBufferWidget->setStyleSheet(INPUT_BUFFER_AREA_STYLE);
-    QHBoxLayout *hBoxLayout = new QHBoxLayout(inputBufferWidget);
+    hideCandidateArea();
+    delete userDictionary;//析构时等待写线程写完已有的记录
+    userDictionary = new UserDictionary(filePath,this);
+    layeredDictionary.setLayer(USERLAYERNAME,QSharedPointer<const DictionaryIndex>(userDictionary,keepDictionaryIndex),
+                               USERLAYERRANKBIAS,QString(),true);
+    phraseChainEdit = NULL;
+    phraseChainPinyin.clear();
+    phraseChainWord.clear();
+    phraseChainLastWord.clear();
+    learnedTransitionList.clear();
+    dictionaryLayersChanged();//学习的词组参与整句解码
+}
+/*
+ *@brief:   设置压缩字典页面缓存的内存预算，所有键盘及所有压缩字典共用。压缩字典按拼音首字母
+ * 分片，查询时从映射的文件调入页面，超出预算时淘汰最久未使用的页面。文本字典仍全部驻留内存，
+ * 内存紧张的设备应使用压缩字典
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   bytes:内存预算(字节)
+ */
+void SoftKeyboard::setDictionaryMemoryBudget(int bytes)
+{
+    CompressedDictionary::setMemoryBudget(bytes);
+}
+/*
+ *@brief:   获取压缩字典的页面驻留统计，包括驻留的分片数、页面数、调入及淘汰次数
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+CompressedDictionary::Statistics SoftKeyboard::dictionaryResidencyStatistics() const
+{
+    return CompressedDictionary::statistics();
+}
+/*
+ *@brief:   加载英文词频表，英文输入时用候选区显示单词补全及下一个单词的联想
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:词频表文件路径，格式见EnglishCompleter::load()
+ *@return:  文件是否打开成功
+ */
+bool SoftKeyboard::loadEnglishWords(const QString &filePath)
+{
+    return englishCompleter.load(filePath);
+}
+/*
+ *@brief:   加载短语表，中文输入时编码以输入的拼音开头的短语显示在第一个候选词之后
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:短语表文件路径，格式见SnippetTable::load()
+ *@return:  文件是否打开成功
+ */
+bool SoftKeyboard::loadSnippets(const QString &filePath)
+{
+    return snippetTable.load(filePath);
+}
+/*
+ *@brief:   获取短语查询的开销统计
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+SnippetTable::Statistics SoftKeyboard::snippetStatistics() const
+{
+    return snippetTable.statistics();
+}
+/*
+ *@brief:   获取英文补全的开销统计
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+EnglishCompleter::Statistics SoftKeyboard::englishCompletionStatistics() const
+{
+    return englishCompleter.statistics();
+}
+/*
+ *@brief:   设置九宫格拼音输入使能。使能后按键区换成九宫格数字键，每个数字键对应多个字母，
+ * 输入的数字串通过数字串索引查找对应的拼音，再按拼音匹配中文。九宫格只用于中文输入
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   enabled:九宫格输入使能
+ */
+void SoftKeyboard::setT9ModeEnabled(bool enabled)
+{
+    if(enabled && isStrokeMode)
+    {
+        setStrokeModeEnabled(false);
+    }
+    hideCandidateArea();
+    isT9Mode = enabled;
+    if(enabled && isENInput)
+    {
+        changeChEnSlot();
+    }
+    keysArea->setVisible(!enabled);
+    t9KeysArea->setVisible(enabled);
+    if(enabled && (t9Index.isEmpty() || t9Generation != dictionaryGeneration))
+    {
+        buildT9IndexAsync();//索引需要遍历字典所有的键，在后台构建
+    }
+}
+/*
+ *@brief:   获取九宫格数字串查询的开销统计
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+T9Index::Statistics SoftKeyboard::t9Statistics() const
+{
+    return t9Index.statistics();
+}
+/*
+ *@brief:   设置笔画输入使能。使能后按键区换成横、竖、撇、点、折五个笔画键，按笔顺输入笔画，
+ * 候选条显示笔画前缀对应的字词，常用的在前。笔画输入只用于中文输入，与九宫格输入互斥，
+ * 需要程序目录下的笔画表
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   enabled:笔画输入使能
+ *@return:  是否设置成功，笔画表不存在时不能使能
+ */
+bool SoftKeyboard::setStrokeModeEnabled(bool enabled)
+{
+    if(enabled && !strokeIndex.hasStrokes() && !strokeIndex.loadStrokes(STROKEFILEPATH))
+    {
+        qDebug()<<"setStrokeModeEnabled():cannot open"<<STROKEFILEPATH;
+        return false;
+    }
+    if(enabled && isT9Mode)
+    {
+        setT9ModeEnabled(false);
+    }
+    hideCandidateArea();
+    isStrokeMode = enabled;
+    if(enabled && isENInput)
+    {
+        changeChEnSlot();
+    }
+    keysArea->setVisible(!enabled);
+    strokeKeysArea->setVisible(enabled);
+    if(enabled && (strokeIndex.isEmpty() || strokeGeneration != dictionaryGeneration))
+    {
+        buildStrokeIndexAsync();//索引需要遍历字典所有的字词，在后台构建
+    }
+    return true;
+}
+/*
+ *@brief:   获取笔画查询的开销统计，包括直接取预排序结果的次数
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+StrokeIndex::Statistics SoftKeyboard::strokeStatistics() const
+{
+    return strokeIndex.statistics();
+}
+/*
+ *@brief:   设置按键及候选词文字图片缓存的大小，内存紧张的设备可以减小，为0时每次重绘都重新渲染
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   bytes:缓存大小(字节)
+ */
+void SoftKeyboard::setTextCacheSize(int bytes)
+{
+    textPixmapCache.setMaxBytes(bytes);
+}
+/*
+ *@brief:   获取文字图片缓存的统计，命中次数与渲染次数之比反映缓存大小是否合适
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+TextPixmapCache::Statistics SoftKeyboard::textCacheStatistics() const
+{
+    return textPixmapCache.statistics();
+}
+/*
+ *@brief:   设置触摸按键按下即提交，默认松开时提交。只影响触摸输入，鼠标点击仍在松开时提交
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   enabled:按下即提交使能
+ */
+void SoftKeyboard::setPressCommitEnabled(bool enabled)
+{
+    touchKeyInput->setPressCommitEnabled(enabled);
+}
+/*
+ *@brief:   设置触摸按键预览，按下字符按键时在按键上方显示放大的字符
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   enabled:按键预览使能
+ */
+void SoftKeyboard::setKeyPreviewEnabled(bool enabled)
+{
+    touchKeyInput->setPreviewEnabled(enabled);
+}
+/*
+ *@brief:   获取触摸输入统计，包括触摸点数、按键翻转次数及触摸事件到按键提交完成的耗时
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+TouchKeyInput::Statistics SoftKeyboard::touchInputStatistics() const
+{
+    return touchKeyInput->statistics();
+}
+/*
+ *@brief:   获取运行统计快照，包括字典规模、拼音键扩展倍数、内存估算、字典加载各阶段耗时、
+ * 每次按键匹配、显示及绘制的耗时分布，以及各功能模块的开销统计。耗时在输入过程中随时记录，
+ * 只有部件个数、候选词内存等在获取快照时计算
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@return:  统计快照
+ */
+RuntimeStatistics SoftKeyboard::runtimeStatistics() const
+{
+    RuntimeStatistics stats;
+    stats.layerCount = layeredDictionary.layerNames().size();
+    stats.dictionaryGeneration = dictionaryGeneration;
+    stats.dictionary = layeredDictionary.loadStatistics();
+    stats.dictionaryLoadNsecs = dictionaryLoadNsecs;
+    stats.candidateBytes = 0;
+    for(int i=0;i<hanzi.size();i++)
+    {
+        stats.candidateBytes += STRINGHEADERBYTES+(hanzi.at(i).size()+1)*sizeof(QChar);
+    }
+    stats.widgetCount = findChildren<QWidget *>().size();
+    stats.textCache = textPixmapCache.statistics();
+    stats.residency = CompressedDictionary::statistics();
+    stats.matchHistogram = matchHistogram;
+    stats.displayHistogram = displayHistogram;
+    stats.paintHistogram = candidateBar?candidateBar->paintStatistics():LatencyHistogram();
+    stats.touchInput = touchKeyInput->statistics();
+    stats.fuzzyPinyin = fuzzyPinyin.statistics();
+    stats.typoCorrection = pinyinCorrector.statistics();
+    stats.englishCompletion = englishCompleter.statistics();
+    stats.snippet = snippetTable.statistics();
+    stats.t9 = t9Index.statistics();
+    stats.stroke = strokeIndex.statistics();
+    return stats;
+}
+/*
+ *@brief:   清零按键耗时分布及各功能模块的开销统计，字典规模及加载耗时不清零
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::resetRuntimeStatistics()
+{
+    matchHistogram.clear();
+    displayHistogram.clear();
+    if(candidateBar)
+    {
+        candidateBar->resetPaintStatistics();
+    }
+    textPixmapCache.resetStatistics();
+    CompressedDictionary::resetStatistics();
+    touchKeyInput->resetStatistics();
+    fuzzyPinyin.resetStatistics();
+    pinyinCorrector.resetStatistics();
+    englishCompleter.resetStatistics();
+    snippetTable.resetStatistics();
+    t9Index.resetStatistics();
+    strokeIndex.resetStatistics();
+}
+/*
+ *@brief:   设置定时输出运行统计到调试日志，用于现场排查输入卡顿
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   msecs:输出间隔(ms)，0为关闭
+ */
+void SoftKeyboard::setStatisticsLogInterval(int msecs)
+{
+    if(msecs <= 0)
+    {
+        statisticsLogTimer->stop();
+        return;
+    }
+    statisticsLogTimer->start(msecs);
+}
+/*
+ *@brief:   鼠标按下事件处理
+ *@author:  缪庆瑞
+ *@date:    2019.7.5
+ */
+void SoftKeyboard::mousePressEvent(QMouseEvent *event)
+{
+    if(event->button()==Qt::LeftButton)//左键按下
+    {
+        isMousePress = true;
+        cursorGlobalPos =event->globalPos();//获取鼠标按下时的全局位置
+        //qDebug()<<"mouse press:"<<cursorGlobalPos;
+    }
+}
+/*
+ *@brief:   鼠标移动事件处理
+ *@author:  缪庆瑞
+ *@date:    2019.7.5
+ */
+void SoftKeyboard::mouseMoveEvent(QMouseEvent *event)
+{
+    //不可以用event.button()==Qt::LeftButton来判断，因为在鼠标移动事件里该方法一直返回Qt::NoButton
+    if(event->buttons()&Qt::LeftButton && isMousePress && isMoveEnabled)
+    {
+        //qDebug()<<"mouse move:"<<event->globalPos();
+        QPoint position = this->pos() + event->globalPos() - cursorGlobalPos;
+        move(position.x(), position.y());
+        cursorGlobalPos = event->globalPos();
+    }
+}
+/*
+ *@brief:   鼠标释放事件处理
+ *@author:  缪庆瑞
+ *@date:    2019.7.5
+ */
+void SoftKeyboard::mouseReleaseEvent(QMouseEvent *event)
+{
+    if(event->button()==Qt::LeftButton)//左键按下
+    {
+        isMousePress = false;
+        //qDebug()<<"mouse release:";
+    }
+}
+/*
+ *@brief:   键盘窗口自身获得焦点时(未显示输入缓存区且外部编辑框在其他窗口)的按键处理，
+ * 不属于中文输入流程的按键转发给当前输入部件
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::keyPressEvent(QKeyEvent *event)
+{
+    if(isPhysicalKeyboard && processPhysicalKey(event))
+    {
+        return;
+    }
+    QWidget *inputWidget = currentInputWidget();
+    if(isPhysicalKeyboard && inputWidget && inputWidget != this && !isAncestorOf(inputWidget))
+    {
+        QCoreApplication::sendEvent(inputWidget,event);
+        return;
+    }
+    QWidget::keyPressEvent(event);
+}
+/*
+ *@brief:   当前输入部件的按键事件过滤，键盘显示时由中文输入流程处理实体键盘的按键
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+bool SoftKeyboard::eventFilter(QObject *watched, QEvent *event)
+{
+    if(watched == keyEventSource && event->type() == QEvent::KeyPress && isVisible())
+    {
+        if(processPhysicalKey(static_cast<QKeyEvent *>(event)))
+        {
+            return true;
+        }
+    }
+    return QWidget::eventFilter(watched,event);
+}
+/*
+ *@brief:   显示事件处理，首次显示前未调用showInputBufferArea()或hideInputBufferArea()指定输入编辑框
+ * 时，与原来构造时的默认设置一样以内置编辑框为当前编辑框。已通过setInputTarget()指定组合输入
+ * 目标时保留该目标，不显示输入缓存区
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::showEvent(QShowEvent *event)
+{
+    if(!currentLineEdit)
+    {
+        if(inputTarget)
+        {
+            ensureInputBufferArea();
+            currentLineEdit = inputContentEdit;//取消组合输入目标后使用内置编辑框
+        }
+        else
+        {
+            showInputBufferArea();
+        }
+    }
+    QWidget::showEvent(event);
+}
+/*
+ *@brief:   空闲时创建延后的部件，每次只创建一部分，避免长时间阻塞事件循环
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::lazyInitSlot()
+{
+    if(!candidateArea)
+    {
+        ensureCandidateArea();
+        warmTextCacheSlot();//预先渲染常用候选字
+        lazyInitTimer->start();
+    }
+    else if(!inputBufferWidget)
+    {
+        ensureInputBufferArea();
+    }
+}
+/*
+ *@brief:   初始化样式表，即用于界面皮肤选择
+ *@author:  缪庆瑞
+ *@date:    2020.05.09
+ */
+void SoftKeyboard::initStyleSheet()
+{
+    /*皮肤1:雅黑*/
+    //按键区域样式
+    keysAreaStyle.append(
+                ".QWidget{background-color:#1E1E1E;}"
+                "QToolButton{background-color:#4E4E4E;color:#E6E6E6;border-radius:4px;}"
+                "QToolButton#specialKeyStyle{background-color:#2D2D2D;border-radius:2px;}");
+    //功能和候选区区域样式 目前与按键区域样式一致
+    functionAndCandidateAreaStyle.append(
+                "QWidget{background-color:#1E1E1E;color:#E6E6E6;}"
+                "QToolButton{border-style:none;}"
+                "QLineEdit{background-color:#4E4E4E;}");
+    /*皮肤2:简白*/
+    keysAreaStyle.append(
+                ".QWidget{background-color:#D8D8D8;}"
+                "QToolButton{background-color:#FFFFFF;color:black;border-radius:6px;}"
+                "QToolButton#specialKeyStyle{background-color:#EBEBEB;border-radius:6px;}");
+    functionAndCandidateAreaStyle.append(
+                "QWidget{background-color:#D8D8D8;color:black;}"
+                "QToolButton{border-style:none;}"
+                "QLineEdit{background-color:white;}");
+    /*皮肤3:魅紫*/
+    keysAreaStyle.append(
+                ".QWidget{background-color:#190724;}"
+                "QToolButton{background-color:#272A5E;color:#68CBF2;border-radius:4px;}"
+                "QToolButton#specialKeyStyle{background-color:#241D48;border-radius:2px;}");
+    functionAndCandidateAreaStyle.append(
+                "QWidget{background-color:#190724;color:#68CBF2;}"
+                "QToolButton{border-style:none;}"
+                "QLineEdit{background-color:#272A5E;}");
+}
+/*
+ *@brief:   初始化软键盘的数字字母(字符)按键
+ *@author:  缪庆瑞
+ *@date:    2020.05.09
+ */
+void SoftKeyboard::initNumberLetterBtn()
+{
+    //以下36个按键，仅作为普通输入，无其他功能，所以连接一个槽函数
+    for(int i=0;i<36;i++)//为10个数字，26个字母按键申请空间,连接信号与槽
+    {
+        numberLetterBtn[i] = new CachedTextButton(&textPixmapCache);
+        numberLetterBtn[i]->setToolButtonStyle(Qt::ToolButtonTextOnly);
+        numberLetterBtn[i]->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+        connect(numberLetterBtn[i],SIGNAL(clicked()),this,SLOT(numberLetterBtnSlot()));
+    }
+}
+/*
+ *@brief:   初始化软键盘的特殊功能按键,诸如大小写切换/删除等
+ *@author:  缪庆瑞
+ *@date:    2020.05.09
+ */
+void SoftKeyboard::initSpecialBtn()
+{
+    upperOrLowerBtn = new QToolButton();
+    upperOrLowerBtn->setObjectName("specialKeyStyle");
+    upperOrLowerBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    upperOrLowerBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    upperOrLowerBtn->setText("A/a");
+    connect(upperOrLowerBtn,SIGNAL(clicked()),this,SLOT(changeUpperLowerSlot()));
+
+    deleteBtn = new QToolButton();
+    deleteBtn->setObjectName("specialKeyStyle");
+    deleteBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    deleteBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    deleteBtn->setText("del");
+    deleteBtn->setAutoRepeatDelay(300);
+    deleteBtn->setAutoRepeatInterval(60);
+    deleteBtn->setAutoRepeat(true);//启用自动重复功能，实现长按连续动作
+    connect(deleteBtn,SIGNAL(clicked(bool)),this,SLOT(deleteTextSlot()));
+
+    skinBtn = new QToolButton();
+    skinBtn->setObjectName("specialKeyStyle");
+    skinBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    skinBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    skinBtn->setText("skin");
+    connect(skinBtn,SIGNAL(clicked()),this,SLOT(changeSkinSlot()));
+
+    letterOrSymbolBtn = new QToolButton();
+    letterOrSymbolBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    letterOrSymbolBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    letterOrSymbolBtn->setText("abc");
+    connect(letterOrSymbolBtn,SIGNAL(clicked()),this,SLOT(changeLetterSymbolSlot()));
+
+    commaBtn = new QToolButton();
+    commaBtn->setMinimumSize(36,16);//设置最小大小，主要是为了清掉布局的默认最佳大小
+    commaBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    commaBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    commaBtn->setText(",");
+    connect(commaBtn,SIGNAL(clicked()),this,SLOT(numberLetterBtnSlot()));
+
+    spaceBtn = new QToolButton();
+    spaceBtn->setText(" ");
+    spaceBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    spaceBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    connect(spaceBtn,SIGNAL(clicked()),this,SLOT(spaceSlot()));
+
+    periodBtn = new QToolButton();
+    periodBtn->setMinimumSize(36,16);
+    periodBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    periodBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    periodBtn->setText(".");
+    connect(periodBtn,SIGNAL(clicked()),this,SLOT(numberLetterBtnSlot()));
+
+    chOrEnBtn = new QToolButton();
+    chOrEnBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    chOrEnBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    chOrEnBtn->setText("CH");
+    isENInput = false;//初始化为中文输入
+    connect(chOrEnBtn,SIGNAL(clicked()),this,SLOT(changeChEnSlot()));
+
+    enterBtn = new QToolButton();
+    enterBtn->setObjectName("specialKeyStyle");
+    enterBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    enterBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    enterBtn->setText("  Enter  ");
+    connect(enterBtn,SIGNAL(clicked()),this,SLOT(enterSlot()));
+}
+/*
+ *@brief:   数字及小写字母按键的文本，按按键区从左到右、从上到下的顺序排列
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+QStringList SoftKeyboard::letterLowList()
+{
+    QStringList letterLowList;
+    letterLowList<<"1"<<"2"<<"3"<<"4"<<"5"<<"6"<<"7"<<"8"<<"9"<<"0"
+                 <<"q"<<"w"<<"e"<<"r"<<"t"<<"y"<<"u"<<"i"<<"o"<<"p"
+                 <<"a"<<"s"<<"d"<<"f"<<"g"<<"h"<<"j"<<"k"<<"l"
+                 <<"z"<<"x"<<"c"<<"v"<<"b"<<"n"<<"m";
+    return letterLowList;
+}
+/*
+ *@brief:   设置小写字母显示
+ *@author:  缪庆瑞
+ *@date:    2020.05.09
+ */
+void SoftKeyboard::setLetterLow()
+{
+    this->isLetterInput = true;
+    this->isLetterLower = true;
+    this->letterOrSymbolBtn->setText("abc");
+    QStringList letterLowList = this->letterLowList();
+    for(int i=0;i<36;i++)
+    {
+        numberLetterBtn[i]->setText(letterLowList.at(i));
+    }
+}
+/*
+ *@brief:   设置大写字母显示
+ *@author:  缪庆瑞
+ *@date:    2020.05.09
+ */
+void SoftKeyboard::setLetterUpper()
+{
+    this->isLetterInput = true;
+    this->isLetterLower = false;
+    this->letterOrSymbolBtn->setText("abc");
+    QStringList letterUpperList;
+    letterUpperList<<"1"<<"2"<<"3"<<"4"<<"5"<<"6"<<"7"<<"8"<<"9"<<"0"
+                   <<"Q"<<"W"<<"E"<<"R"<<"T"<<"Y"<<"U"<<"I"<<"O"<<"P"
+                   <<"A"<<"S"<<"D"<<"F"<<"G"<<"H"<<"J"<<"K"<<"L"
+                   <<"Z"<<"X"<<"C"<<"V"<<"B"<<"N"<<"M";
+    for(int i=0;i<36;i++)
+    {
+        numberLetterBtn[i]->setText(letterUpperList.at(i));
+    }
+}
+/*
+ *@brief:   设置符号显示，包含所有可输入符号(英文状态)
+ *@author:  缪庆瑞
+ *@date:    2020.05.09
+ */
+void SoftKeyboard::setSymbolsEN()
+{
+    this->isLetterInput = false;
+    this->letterOrSymbolBtn->setText(":;?");
+    QStringList symbolsENList;
+    symbolsENList<<"!"<<"@"<<"#"<<"$"<<"%"<<"^"<<"&&"<<"*"<<"("<<")"
+               <<"["<<"]"<<"{"<<"}"<<"<"<<">"<<"+"<<"-"<<"_"<<"="
+               <<"`"<<"~"<<"|"<<"\\"<<"'"<<"\""<<":"<<";"<<"?"
+               <<"/"<<"..."<<"---"<<"www."<<".com"<<".cn"<<".net";
+    for(int i=0;i<36;i++)
+    {
+        numberLetterBtn[i]->setText(symbolsENList.at(i));
+    }
+}
+/*
+ *@brief:   设置符号显示，包含所有可输入符号(中文状态)
+ *@author:  缪庆瑞
+ *@date:    2020.05.09
+ */
+void SoftKeyboard::setSymbolsCH()
+{
+    this->isLetterInput = false;
+    this->letterOrSymbolBtn->setText(":;?");
+    QStringList symbolsCHList;
+    //为了兼容Qt4  中文状态下特有的字符用fromUtf8转换,避免使用tr()影响国际化翻译
+    symbolsCHList<<QString::fromUtf8("！")<<"@"<<"#"<<QString::fromUtf8("￥")<<"%"<<QString::fromUtf8("…")<<"&&"<<"*"<<QString::fromUtf8("（")<<QString::fromUtf8("）")
+            <<QString::fromUtf8("【")<<QString::fromUtf8("】")<<"{"<<"}"<<QString::fromUtf8("《")<<QString::fromUtf8("》")<<"+"<<"-"<<QString::fromUtf8("—")<<"="
+            <<"."<<"~"<<"|"<<QString::fromUtf8("、")<<QString::fromUtf8("’")<<QString::fromUtf8("‘")<<QString::fromUtf8("“")<<QString::fromUtf8("”")<<QString::fromUtf8("：")
+            <<QString::fromUtf8("；")<<QString::fromUtf8("？")<<QString::fromUtf8("♀")<<QString::fromUtf8("℃")<<QString::fromUtf8("★")<<QString::fromUtf8("→")<<QString::fromUtf8("←");
+    for(int i=0;i<36;i++)
+    {
+        numberLetterBtn[i]->setText(symbolsCHList.at(i));
+    }
+}
+/*
+ *@brief:   初始化键盘输入缓存区，临时存放显示输入的内容
+ *@author:  缪庆瑞
+ *@date:    2019.7.5
+ */
+void SoftKeyboard::initInputBufferArea()
+{
+    //输入缓存区 内部的标题和编辑框在首次使用或空闲时创建
+    inputBufferArea = new QWidget();
+    QHBoxLayout *inputBufferAreaLayout = new QHBoxLayout(inputBufferArea);
+    inputBufferAreaLayout->setMargin(0);
+    inputBufferWidget = NULL;
+    inputTitleLabel = NULL;
+    inputContentEdit = NULL;
+    currentLineEdit = NULL;
+}
+/*
+ *@brief:   创建输入缓存区的标题和编辑框，已创建时直接返回
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::ensureInputBufferArea()
+{
+    if(inputBufferWidget)
+    {
+        return;
+    }
+    //输入缓存标题
+    inputTitleLabel = new QLabel();
+    inputTitleLabel->setSizePolicy(QSizePolicy::Fixed,QSizePolicy::Preferred);
+    //输入缓存内容编辑框
+    inputContentEdit = new QLineEdit();
+    inputContentEdit->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    //输入缓存部件
+    inputBufferWidget = new QWidget();
+    //inputBufferWidget->setStyleSheet(INPUT_BUFFER_AREA_STYLE);
+    QHBoxLayout *hBoxLayout = new QHBoxLayout(inputBufferWidget);
     hBoxLayout->setContentsMargins(10,6,10,6);
     hBoxLayout->setSpacing(15);
     hBoxLayout->addWidget(inputTitleLabel);
     hBoxLayout->addWidget(inputContentEdit);
-    //输入缓存区
-    inputBufferArea = new QWidget();
-    QHBoxLayout *inputBufferAreaLayout = new QHBoxLayout(inputBufferArea);
-    inputBufferAreaLayout->setMargin(0);
+    QHBoxLayout *inputBufferAreaLayout = static_cast<QHBoxLayout *>(inputBufferArea->layout());
     inputBufferAreaLayout->addStretch(1);
     inputBufferAreaLayout->addWidget(inputBufferWidget,2);
     inputBufferAreaLayout->addStretch(1);
+}
+/*
+ *@brief:   初始化功能和候选词区域,该区域使用栈部件,同一时刻只显示一个区域
+ *@author:  缪庆瑞
+ *@date:    2020.05.09
+ */
+void SoftKeyboard::initFunctionAndCandidateArea()
+{
+    /*****************功能区*****************/
+    //介绍
+    introduceLabel = new QLabel();
+    introduceLabel->setAlignment(Qt::AlignCenter);
+    introduceLabel->setText(QString::fromUtf8("欢迎使用中文输入软键盘"));
+
+    functionArea = new QWidget();
+    QHBoxLayout *functionAreaLayout = new QHBoxLayout(functionArea);
+    functionAreaLayout->setContentsMargins(8,0,8,0);
+    functionAreaLayout->addWidget(introduceLabel);
+    //候选区在首次输入或空闲时创建
+    candidateArea = NULL;
+    candidateLetter = NULL;
+    candidateBar = NULL;
+    /***************栈部件存放功能区和候选区******************/
+    functionAndCandidateArea = new QStackedWidget();
+    functionAndCandidateArea->addWidget(functionArea);
+}
+/*
+ *@brief:   创建候选区，包括候选字母显示框和候选条，已创建时直接返回
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::ensureCandidateArea()
+{
+    if(candidateArea)
+    {
+        return;
+    }
+    //候选字母显示框
+    candidateLetter = new QLineEdit();
+    candidateLetter->setFrame(false);
+    candidateLetter->setEnabled(false);
+    candidateLetter->setSizePolicy(QSizePolicy::Fixed,QSizePolicy::Fixed);//水平方向固定大小
+    connect(candidateLetter,SIGNAL(textChanged(QString)),this,SLOT(candidateLetterChangedSlot(QString)));
+    //候选条 候选词按文字宽度排列，拖动滚动，需要时分批获取
+    candidateBar = new CandidateBar(&textPixmapCache);
+    connect(candidateBar,SIGNAL(candidateClicked(QString)),this,SLOT(candidateWordClickedSlot(QString)));
+    connect(candidateBar,SIGNAL(moreCandidatesRequested()),this,SLOT(fetchCandidateWordSlot()));
+
+    candidateArea = new QWidget();
+    QVBoxLayout *vBoxLayout = new QVBoxLayout(candidateArea);
+    vBoxLayout->setMargin(0);
+    vBoxLayout->setSpacing(0);
+    vBoxLayout->addWidget(candidateLetter);
+    vBoxLayout->addWidget(candidateBar);
+    candidateLetter->setVisible(!inputTarget);
+    functionAndCandidateArea->addWidget(candidateArea);
+}
+/*
+ *@brief:   显示候选区，未创建时先创建
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::showCandidateArea()
+{
+    ensureCandidateArea();
+    functionAndCandidateArea->setCurrentWidget(candidateArea);
+}
+/*
+ *@brief:   初始化键盘按键区域
+ *@author:  缪庆瑞
+ *@date:    2020.05.09
+ */
+void SoftKeyboard::initKeysArea()
+{
+    initNumberLetterBtn();//初始化10个数字，26个字母或字符按键
+    initSpecialBtn();//初始化特殊按键
+    setLetterLow();//默认显示字母界面 小写
+
+    //布局第一排按键 10个数字
+    QHBoxLayout *firstRowHLayout = new QHBoxLayout();
+    for(int i=0;i<10;i++)
+    {
+        firstRowHLayout->addWidget(numberLetterBtn[i]);
+    }
+    //布局第二排按键
+    QHBoxLayout *secondRowHLayout = new QHBoxLayout();
+    for(int i=10;i<20;i++)
+    {
+        secondRowHLayout->addWidget(numberLetterBtn[i]);
+    }
+    //布局第三排按键
+    QHBoxLayout *thirdRowHLayout = new QHBoxLayout();
+    thirdRowHLayout->setContentsMargins(20,0,20,0);
+    for(int i=20;i<29;i++)
+    {
+        thirdRowHLayout->addWidget(numberLetterBtn[i]);
+    }
+    //布局第四排按键
+    QHBoxLayout *fourthRowHLayout = new QHBoxLayout();
+    fourthRowHLayout->addWidget(upperOrLowerBtn);//大小写切换按键
+    for(int i =29;i<36;i++)
+    {
+        fourthRowHLayout->addWidget(numberLetterBtn[i]);
+    }
+    fourthRowHLayout->addWidget(deleteBtn);//删除按键
+    //布局第五排按键，基本为特殊功能按键
+    QHBoxLayout *fifthRowHLayout = new QHBoxLayout();
+    fifthRowHLayout->addWidget(skinBtn,2);
+    fifthRowHLayout->addWidget(letterOrSymbolBtn,1);
+    fifthRowHLayout->addWidget(commaBtn,1);
+    fifthRowHLayout->addWidget(spaceBtn,4);
+    fifthRowHLayout->addWidget(periodBtn,1);
+    fifthRowHLayout->addWidget(chOrEnBtn,1);
+    fifthRowHLayout->addWidget(enterBtn,2);
+
+    keysArea = new QWidget();
+    QVBoxLayout *vBoxlayout = new QVBoxLayout(keysArea);
+    vBoxlayout->setContentsMargins(8,2,8,8);
+    vBoxlayout->addLayout(firstRowHLayout);
+    vBoxlayout->addLayout(secondRowHLayout);
+    vBoxlayout->addLayout(thirdRowHLayout);
+    vBoxlayout->addLayout(fourthRowHLayout);
+    vBoxlayout->addLayout(fifthRowHLayout);
+}
+/*
+ *@brief:   初始化九宫格按键区域，默认隐藏。数字键2~9显示对应的字母，1输入标点，0为空格
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::initT9KeysArea()
+{
+    for(int i=0;i<10;i++)
+    {
+        t9DigitBtn[i] = new CachedTextButton(&textPixmapCache);
+        t9DigitBtn[i]->setToolButtonStyle(Qt::ToolButtonTextOnly);
+        t9DigitBtn[i]->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+        t9DigitBtn[i]->setText(QString::number(i)+"\n"+T9Index::keyLetters(i));
+    }
+    t9DigitBtn[1]->setText(QString::fromUtf8("1\n，"));
+    t9DigitBtn[0]->setText(QString::fromUtf8("0\n空格"));
+    for(int i=1;i<10;i++)
+    {
+        connect(t9DigitBtn[i],SIGNAL(clicked()),this,SLOT(t9DigitBtnSlot()));
+    }
+    connect(t9DigitBtn[0],SIGNAL(clicked()),this,SLOT(spaceSlot()));
+
+    t9DeleteBtn = new QToolButton();
+    t9DeleteBtn->setObjectName("specialKeyStyle");
+    t9DeleteBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    t9DeleteBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    t9DeleteBtn->setText("del");
+    t9DeleteBtn->setAutoRepeatDelay(300);
+    t9DeleteBtn->setAutoRepeatInterval(60);
+    t9DeleteBtn->setAutoRepeat(true);
+    connect(t9DeleteBtn,SIGNAL(clicked(bool)),this,SLOT(deleteTextSlot()));
+
+    t9SpellingBtn = new QToolButton();
+    t9SpellingBtn->setObjectName("specialKeyStyle");
+    t9SpellingBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    t9SpellingBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    t9SpellingBtn->setText(QString::fromUtf8("拼音"));
+    connect(t9SpellingBtn,SIGNAL(clicked()),this,SLOT(t9SpellingSlot()));
+
+    t9EnterBtn = new QToolButton();
+    t9EnterBtn->setObjectName("specialKeyStyle");
+    t9EnterBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    t9EnterBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    t9EnterBtn->setText("Enter");
+    connect(t9EnterBtn,SIGNAL(clicked()),this,SLOT(enterSlot()));
+
+    t9KeysArea = new QWidget();
+    QGridLayout *gridLayout = new QGridLayout(t9KeysArea);
+    gridLayout->setContentsMargins(8,2,8,8);
+    for(int i=1;i<10;i++)//1~9 三行三列
+    {
+        gridLayout->addWidget(t9DigitBtn[i],(i-1)/3,(i-1)%3);
+    }
+    gridLayout->addWidget(t9DigitBtn[0],3,0,1,3);
+    gridLayout->addWidget(t9DeleteBtn,0,3);
+    gridLayout->addWidget(t9SpellingBtn,1,3);
+    gridLayout->addWidget(t9EnterBtn,2,3,2,1);
+    t9KeysArea->setVisible(false);
+}
+/*
+ *@brief:   初始化笔画输入按键区域，五个笔画键按1横2竖3撇4点5折排列
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::initStrokeKeysArea()
+{
+    QString strokeGlyphs = StrokeIndex::toGlyphs("12345");
+    QStringList strokeNames;
+    strokeNames<<QString::fromUtf8("横")<<QString::fromUtf8("竖")<<QString::fromUtf8("撇")
+               <<QString::fromUtf8("点")<<QString::fromUtf8("折");
+    for(int i=0;i<5;i++)
+    {
+        strokeBtn[i] = new CachedTextButton(&textPixmapCache);
+        strokeBtn[i]->setToolButtonStyle(Qt::ToolButtonTextOnly);
+        strokeBtn[i]->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+        strokeBtn[i]->setText(strokeGlyphs.at(i)+QString("\n")+strokeNames.at(i));
+        connect(strokeBtn[i],SIGNAL(clicked()),this,SLOT(strokeBtnSlot()));
+    }
+    strokeCommaBtn = new QToolButton();
+    strokeCommaBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    strokeCommaBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    strokeCommaBtn->setText(QString::fromUtf8("，"));
+    connect(strokeCommaBtn,SIGNAL(clicked()),this,SLOT(strokeBtnSlot()));
+
+    strokeSpaceBtn = new QToolButton();
+    strokeSpaceBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    strokeSpaceBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    strokeSpaceBtn->setText(QString::fromUtf8("空格"));
+    connect(strokeSpaceBtn,SIGNAL(clicked()),this,SLOT(spaceSlot()));
+
+    strokeDeleteBtn = new QToolButton();
+    strokeDeleteBtn->setObjectName("specialKeyStyle");
+    strokeDeleteBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    strokeDeleteBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    strokeDeleteBtn->setText("del");
+    strokeDeleteBtn->setAutoRepeatDelay(300);
+    strokeDeleteBtn->setAutoRepeatInterval(60);
+    strokeDeleteBtn->setAutoRepeat(true);
+    connect(strokeDeleteBtn,SIGNAL(clicked(bool)),this,SLOT(deleteTextSlot()));
 
+    strokeEnterBtn = new QToolButton();
+    strokeEnterBtn->setObjectName("specialKeyStyle");
+    strokeEnterBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+    strokeEnterBtn->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);
+    strokeEnterBtn->setText("Enter");
+    connect(strokeEnterBtn,SIGNAL(clicked()),this,SLOT(enterSlot()));
+
+    strokeKeysArea = new QWidget();
+    QGridLayout *gridLayout = new QGridLayout(strokeKeysArea);
+    gridLayout->setContentsMargins(8,2,8,8);
+    for(int i=0;i<5;i++)//横竖撇 点折， 两行三列
+    {
+        gridLayout->addWidget(strokeBtn[i],i/3,i%3);
+    }
+    gridLayout->addWidget(strokeCommaBtn,1,2);
+    gridLayout->addWidget(strokeSpaceBtn,2,0,1,3);
+    gridLayout->addWidget(strokeDeleteBtn,0,3);
+    gridLayout->addWidget(strokeEnterBtn,1,3,2,1);
+    strokeKeysArea->setVisible(false);
+}
+/*
+ *@brief:   读拼音字典，将汉字与对应拼音存放到hash表中。首次加载在构造函数中同步完成，
+ * 之后字典文件改变时在后台重新加载。存在分块压缩的拼音字典时优先使用，启动时只读入块索引
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::readDictionary()
+{
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    QString filePath = QFile::exists(COMPRESSEDPINYINFILEPATH)?COMPRESSEDPINYINFILEPATH:PINYINFILEPATH;
+    QSharedPointer<const DictionaryIndex> dictionary = loadSharedDictionary(filePath);//其他键盘已加载时共用
+    if(dictionary.isNull())//拼音文件打开失败提示
+    {
+        QMessageBox::critical(this,"Open File Failed",QString::fromUtf8("无法打开拼音文件。。。"));
+        dictionary = QSharedPointer<const DictionaryIndex>(new PinyinDictionary());
+    }
+    layeredDictionary.setLayer(SYSTEMLAYERNAME,dictionary,0,filePath);
+    dictionaryGeneration = 0;
+    dictionaryLoadNsecs = loadTimer.nsecsElapsed();
 }
 /*
- *@brief:   初始化功能和候选词区域,该区域使用栈部件,同一时刻只显示一个区域
+ *@brief:   在后台线程构建拼音纠错字典树，字典只读，可以与界面线程同时访问
  *@author:  缪庆瑞
- *@date:    2020.05.09
+ *@date:    2026.10.19
+ *@param:   corrector:纠错器(带有按键布局等设置)的副本
+ *@param:   dictionary:分层字典的副本，只访问其中只读的层
  */
-void SoftKeyboard::initFunctionAndCandidateArea()
+static PinyinCorrector buildPinyinCorrector(PinyinCorrector corrector,LayeredDictionary dictionary)
 {
-    /*****************功能区*****************/
-    //介绍
-    introduceLabel = new QLabel();
-    introduceLabel->setAlignment(Qt::AlignCenter);
-    introduceLabel->setText(QString::fromUtf8("欢迎使用中文输入软键盘"));
-
-    functionArea = new QWidget();
-    QHBoxLayout *functionAreaLayout = new QHBoxLayout(functionArea);
-    functionAreaLayout->setContentsMargins(8,0,8,0);
-    functionAreaLayout->addWidget(introduceLabel);
-    /*****************候选区*****************/
-    //候选字母显示框
-    candidateLetter = new QLineEdit();
-    candidateLetter->setFrame(false);
-    candidateLetter->setEnabled(false);
-    candidateLetter->setSizePolicy(QSizePolicy::Fixed,QSizePolicy::Fixed);//水平方向固定大小
-    connect(candidateLetter,SIGNAL(textChanged(QString)),this,SLOT(candidateLetterChangedSlot(QString)));
-    //候选词、翻页按钮显示区域
-    candidateWordArea = new QWidget();
-    QHBoxLayout *candidateWordAreaLayout = new QHBoxLayout(candidateWordArea);
-    candidateWordAreaLayout->setMargin(0);
-    for(int i=0;i<CANDIDATEWORDNUM;i++)
-    {
-        candidateWordBtn[i] = new QToolButton();
-        candidateWordBtn[i]->setToolButtonStyle(Qt::ToolButtonTextOnly);
-        candidateWordBtn[i]->setSizePolicy(QSizePolicy::Preferred,QSizePolicy::Preferred);   
-        connect(candidateWordBtn[i],SIGNAL(clicked()),this,SLOT(candidateWordBtnSlot()));
-        candidateWordAreaLayout->addWidget(candidateWordBtn[i]);
-    }
-    prePageBtn = new QToolButton();//上一页
-    prePageBtn->setObjectName("pageBtn");
-    prePageBtn->setText("   <   ");
-    prePageBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    prePageBtn->setSizePolicy(QSizePolicy::Fixed,QSizePolicy::Preferred);
-    connect(prePageBtn,SIGNAL(clicked()),this,SLOT(candidateWordPrePageSlot()));
-    nextPageBtn = new QToolButton();//下一页
-    nextPageBtn->setObjectName("pageBtn");
-    nextPageBtn->setText("   >   ");
-    nextPageBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
-    nextPageBtn->setSizePolicy(QSizePolicy::Fixed,QSizePolicy::Preferred);
-    connect(nextPageBtn,SIGNAL(clicked()),this,SLOT(candidateWordNextPageSlot()));
-    candidateWordAreaLayout->addWidget(prePageBtn);
-    candidateWordAreaLayout->addWidget(nextPageBtn);
-
-    candidateArea = new QWidget();
-    QVBoxLayout *vBoxLayout = new QVBoxLayout(candidateArea);
-    vBoxLayout->setMargin(0);
-    vBoxLayout->setSpacing(0);
-    vBoxLayout->addWidget(candidateLetter);
-    vBoxLayout->addWidget(candidateWordArea);
-    /***************栈部件存放功能区和候选区******************/
-    functionAndCandidateArea = new QStackedWidget();
-    functionAndCandidateArea->addWidget(functionArea);
-    functionAndCandidateArea->addWidget(candidateArea);
+    corrector.build(dictionary.keys(false));
+    return corrector;
 }
 /*
- *@brief:   初始化键盘按键区域
+ *@brief:   在后台线程构建九宫格数字串索引，与纠错字典树一样只访问只读的层
  *@author:  缪庆瑞
- *@date:    2020.05.09
+ *@date:    2026.10.19
+ *@param:   dictionary:分层字典的副本
  */
-void SoftKeyboard::initKeysArea()
+static T9Index buildT9Index(LayeredDictionary dictionary)
 {
-    initNumberLetterBtn();//初始化10个数字，26个字母或字符按键
-    initSpecialBtn();//初始化特殊按键
-    setLetterLow();//默认显示字母界面 小写
-
-    //布局第一排按键 10个数字
-    QHBoxLayout *firstRowHLayout = new QHBoxLayout();
-    for(int i=0;i<10;i++)
+    T9Index index;
+    index.build(dictionary.keys(false));
+    return index;
+}
+/*
+ *@brief:   在后台线程构建笔画索引。需要遍历字词，只使用只读层的副本
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   index:已读入笔画表的索引副本
+ *@param:   dictionary:分层字典只读层的副本
+ */
+static StrokeIndex buildStrokeIndex(StrokeIndex index,LayeredDictionary dictionary)
+{
+    index.build(dictionary);
+    return index;
+}
+/*
+ *@brief:   初始化字典文件监视。字典文件改变后延时一段时间(合并文件写入过程中的多次改变)，
+ * 在后台线程重新加载字典，加载完成后在界面线程整体替换字典指针。输入过程中始终使用完整的
+ * 旧字典，不会被阻塞也不会看到构建了一半的字典；旧字典在最后一个引用释放后自动删除。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::initDictionaryReload()
+{
+    correctorGeneration = -1;
+    dictionaryWatcher = new QFileSystemWatcher(this);
+    dictionaryWatcher->addPaths(layeredDictionary.layerFilePaths());
+    connect(dictionaryWatcher,SIGNAL(fileChanged(QString)),this,SLOT(dictionaryFileChangedSlot(QString)));
+    dictionaryReloadTimer = new QTimer(this);
+    dictionaryReloadTimer->setSingleShot(true);
+    dictionaryReloadTimer->setInterval(DICTRELOADDELAY);
+    connect(dictionaryReloadTimer,SIGNAL(timeout()),this,SLOT(reloadDictionarySlot()));
+    dictionaryReloadWatcher = new QFutureWatcher<QSharedPointer<const DictionaryIndex> >(this);
+    connect(dictionaryReloadWatcher,SIGNAL(finished()),this,SLOT(dictionaryReloadedSlot()));
+    correctorBuildWatcher = new QFutureWatcher<PinyinCorrector>(this);
+    connect(correctorBuildWatcher,SIGNAL(finished()),this,SLOT(correctorBuiltSlot()));
+    t9Generation = -1;
+    t9BuildWatcher = new QFutureWatcher<T9Index>(this);
+    connect(t9BuildWatcher,SIGNAL(finished()),this,SLOT(t9IndexBuiltSlot()));
+    strokeGeneration = -1;
+    strokeBuildWatcher = new QFutureWatcher<StrokeIndex>(this);
+    connect(strokeBuildWatcher,SIGNAL(finished()),this,SLOT(strokeIndexBuiltSlot()));
+}
+/*
+ *@brief:   由当前各层字典重置整句解码器(共享引用各层的词表)，并加入用户学习的词组。
+ * 非整句模式时不引用词表，压缩字典的整句词表只在整句模式使能后才解压
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::resetSentenceDecoder()
+{
+    sentenceDecoder = SentenceDecoder();
+    if(!isSentenceMode)
     {
-        firstRowHLayout->addWidget(numberLetterBtn[i]);
+        return;
     }
-    //布局第二排按键
-    QHBoxLayout *secondRowHLayout = new QHBoxLayout();
-    for(int i=10;i<20;i++)
+    layeredDictionary.addWordTablesTo(sentenceDecoder);
+    QList<QPair<QString,QString> > learnedPhraseList = userDictionary->learnedPhrases();
+    for(int i=0;i<learnedPhraseList.size();i++)
     {
-        secondRowHLayout->addWidget(numberLetterBtn[i]);
+        sentenceDecoder.addWord(learnedPhraseList.at(i).first,learnedPhraseList.at(i).second,LEARNEDPHRASECOST);
     }
-    //布局第三排按键
-    QHBoxLayout *thirdRowHLayout = new QHBoxLayout();
-    thirdRowHLayout->setContentsMargins(20,0,20,0);
-    for(int i=20;i<29;i++)
+    for(int i=0;i<learnedTransitionList.size();i++)
+    {
+        sentenceDecoder.addTransition(learnedTransitionList.at(i).first,learnedTransitionList.at(i).second,
+                                      LEARNEDTRANSITIONCOST);
+    }
+}
+/*
+ *@brief:   后台构建拼音纠错字典树，构建期间继续使用原有的字典树
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::buildCorrectorAsync()
+{
+    if(correctorBuildWatcher->isRunning())
+    {
+        return;//构建完成后会检查字典是否已经更新
+    }
+    correctorGeneration = dictionaryGeneration;
+    correctorBuildWatcher->setFuture(QtConcurrent::run(buildPinyinCorrector,pinyinCorrector,layeredDictionary));
+}
+/*
+ *@brief:   后台构建九宫格数字串索引，构建期间继续使用原有的索引
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::buildT9IndexAsync()
+{
+    if(t9BuildWatcher->isRunning())
+    {
+        return;//构建完成后会检查字典是否已经更新
+    }
+    t9Generation = dictionaryGeneration;
+    t9BuildWatcher->setFuture(QtConcurrent::run(buildT9Index,layeredDictionary));
+}
+/*
+ *@brief:   后台构建笔画索引，构建期间继续使用原有的索引
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::buildStrokeIndexAsync()
+{
+    if(strokeBuildWatcher->isRunning())
+    {
+        return;//构建完成后会检查字典是否已经更新
+    }
+    strokeGeneration = dictionaryGeneration;
+    strokeBuildWatcher->setFuture(QtConcurrent::run(buildStrokeIndex,strokeIndex,layeredDictionary.readOnlyLayers()));
+}
+/*
+ *@brief:   字典层改变(加载、卸载或重新加载)后，更新整句解码器和纠错字典树，
+ * 正在显示的候选词按新字典重新匹配
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::dictionaryLayersChanged()
+{
+    dictionaryGeneration++;
+    resetSentenceDecoder();
+    if(isTypoCorrection)
+    {
+        buildCorrectorAsync();
+    }
+    if(isT9Mode)
+    {
+        buildT9IndexAsync();
+    }
+    if(isStrokeMode)
+    {
+        buildStrokeIndexAsync();//正在输入的笔画在索引构建完成后重新匹配
+    }
+    else if(functionAndCandidateArea->currentWidget() == candidateArea)
+    {
+        matchChinese(candidateLetter->text());
+        displayCandidateWord();
+    }
+}
+/*
+ *@brief:   根据输入的拼音匹配中文
+ *@author:  缪庆瑞
+ *@date:    2017.1.1
+ *@param:   pinyin:输入的拼音
+ */
+void SoftKeyboard::matchChinese(QString pinyin)
+{
+    pinyinMatchTimer->stop();//同步匹配时取消等待中的合并匹配
+    QElapsedTimer matchTimer;
+    matchTimer.start();
+    hanzi.clear();//每次匹配中文都先清空之前的列表
+    //各层字典中存放着拼音-汉字的键值对（一键多值），获取对应拼音合并后的汉字列表
+    hanzi = layeredDictionary.values(pinyin);
+    //按用户选择的候选词权重调整顺序，只作用于精确匹配的候选词，模糊音和纠错的候选词始终排在其后
+    userDictionary->sortByWeight(pinyin,hanzi);
+    if(fuzzyPinyin.mask() != 0)//模糊音
+    {
+        QElapsedTimer fuzzyTimer;
+        fuzzyTimer.start();
+        QStringList variantList = fuzzyPinyin.expand(pinyin);
+        variantList.removeFirst();//第一个为输入本身
+        appendLowRankCandidates(variantList);
+        fuzzyPinyin.recordQuery(variantList.size(),fuzzyTimer.nsecsElapsed());
+    }
+    if(isTypoCorrection && pinyin.length()>=MINCORRECTIONLENGTH)//拼音纠错
+    {
+        QList<QPair<QString,int> > correctionList = pinyinCorrector.correct(pinyin,MAXCORRECTIONKEYS);
+        QStringList correctedList;
+        for(int i=0;i<correctionList.size();i++)
+        {
+            correctedList.append(correctionList.at(i).first);
+        }
+        appendLowRankCandidates(correctedList);
+    }
+    if(isSentenceMode)//整句模式 解码出的句子作为第一个候选词
+    {
+        QString sentence = sentenceDecoder.decode(pinyin);
+        if(!sentence.isEmpty())
+        {
+            hanzi.removeAll(sentence);
+            hanzi.append(sentence);//候选词从列表末尾反向显示，追加到末尾即显示在第一位
+        }
+    }
+    //短语 显示在第一个候选词之后，没有候选词时显示在最前面
+    snippetCandidates = snippetTable.isEmpty()?QStringList():snippetTable.match(pinyin,MAXSNIPPETCANDIDATES);
+    for(int i=0;i<snippetCandidates.size();i++)
+    {
+        hanzi.removeAll(snippetCandidates.at(i));
+        hanzi.insert(qMax(0,hanzi.size()-1-i),snippetCandidates.at(i));
+    }
+    matchHistogram.add(matchTimer.nsecsElapsed());
+    //qDebug()<<hanzi;
+}
+/*
+ *@brief:   追加排在已有候选词之后的候选词(如模糊音、纠错的匹配结果)，已有的候选词不重复添加。
+ * 候选词列表是反向显示的，所以按显示顺序依次插入到列表前面
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyinList:拼音列表，按优先级由高到低排列
+ */
+void SoftKeyboard::appendLowRankCandidates(const QStringList &pinyinList)
+{
+    if(pinyinList.isEmpty())
+    {
+        return;
+    }
+    QSet<QString> matchedSet;
+    for(int i=0;i<hanzi.size();i++)
+    {
+        matchedSet.insert(hanzi.at(i));
+    }
+    QList<QString> lowRankList;
+    for(int i=0;i<pinyinList.size();i++)
+    {
+        QList<QString> valueList = layeredDictionary.values(pinyinList.at(i));
+        for(int j=valueList.size()-1;j>=0;j--)
+        {
+            if(!matchedSet.contains(valueList.at(j)))
+            {
+                matchedSet.insert(valueList.at(j));
+                lowRankList.prepend(valueList.at(j));
+            }
+        }
+    }
+    hanzi = lowRankList+hanzi;
+}
+/*
+ *@brief:   显示候选词，候选条从头开始显示，先获取第一批候选词，之后随滚动按需获取
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::displayCandidateWord()
+{
+    QElapsedTimer displayTimer;
+    displayTimer.start();
+    fetchedCandidateCount = 0;
+    candidateBar->clear();
+    fetchCandidateWordSlot();
+    displayHistogram.add(displayTimer.nsecsElapsed());
+}
+/*
+ *@brief:   提交候选词到编辑框，同时提高该候选词在用户词典中的权重。
+ * 如果本次选词紧接着上次选词(期间编辑框没有其他改动)，且都是全拼输入，则将连续选择的词组合
+ * 为新词组学习到用户词典中，例:ai选爱、qing选情，学习到词组爱情ai'qing
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   word:选择的候选词
+ */
+void SoftKeyboard::commitCandidateWord(QString word)
+{
+    if(isENInput)
+    {
+        commitEnglishWord(word);
+        return;
+    }
+    if(isStrokeMode)//笔画输入没有拼音，不记录到用户词典
+    {
+        insertText(word);
+        hideCandidateArea();
+        return;
+    }
+    QString pinyin = candidateLetter->text();
+    bool isChainContinued = (phraseChainEdit==currentInputWidget() && textBeforeCursor()==phraseChainText);
+    insertText(word);
+    if(hanzi.contains(word) && !snippetCandidates.contains(word))//短语不记录到用户词典
+    {
+        userDictionary->learnWord(pinyin,word);
+        //全拼输入时的音节数与汉字数一致
+        QStringList syllableList = PinyinSyllable::split(pinyin);
+        bool isFullPinyin = (syllableList.size()==word.length());
+        for(int i=0;isFullPinyin && i<syllableList.size();i++)
+        {
+            isFullPinyin = PinyinSyllable::isSyllable(syllableList.at(i));
+        }
+        if(!isFullPinyin)
+        {
+            phraseChainPinyin.clear();
+            phraseChainWord.clear();
+            phraseChainLastWord.clear();
+        }
+        else if(isChainContinued && !phraseChainWord.isEmpty()
+                && phraseChainWord.length()+word.length()<=MAXLEARNPHRASELENGTH)
+        {
+            phraseChainPinyin += "'"+syllableList.join("'");
+            phraseChainWord += word;
+            if(userDictionary->learnPhrase(phraseChainPinyin,phraseChainWord))
+            {
+                sentenceDecoder.addWord(phraseChainPinyin,phraseChainWord,LEARNEDPHRASECOST);
+            }
+            //相邻的两个词作为整句解码的转移代价，组成更长的句子时同样有效
+            QPair<QString,QString> transition(phraseChainLastWord,word);
+            if(!learnedTransitionList.contains(transition))
+            {
+                learnedTransitionList.append(transition);
+                if(learnedTransitionList.size() > MAXLEARNEDTRANSITIONS)
+                {
+                    learnedTransitionList.removeFirst();
+                }
+                sentenceDecoder.addTransition(transition.first,transition.second,LEARNEDTRANSITIONCOST);
+            }
+            phraseChainLastWord = word;
+        }
+        else
+        {
+            phraseChainPinyin = syllableList.join("'");
+            phraseChainWord = word;
+            phraseChainLastWord = word;
+        }
+        phraseChainEdit = currentInputWidget();
+        phraseChainText = textBeforeCursor();
+    }
+    hideCandidateArea();//隐藏中文候选区域
+}
+/*
+ *@brief:   英文输入时补全正在输入的单词，没有正在输入的单词时联想上一个单词的下一个单词，
+ * 结果按候选词列表的顺序(常用的在后面)存放并显示在候选区，没有结果时显示功能区
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::matchEnglish()
+{
+    QElapsedTimer matchTimer;
+    matchTimer.start();
+    hanzi.clear();
+    QStringList wordList;
+    if(!englishWord.isEmpty())
+    {
+        wordList = englishCompleter.complete(englishWord,MAXENGLISHCANDIDATES);
+    }
+    else if(!previousEnglishWord.isEmpty())
+    {
+        wordList = englishCompleter.nextWords(previousEnglishWord,MAXENGLISHCANDIDATES);
+    }
+    matchHistogram.add(matchTimer.nsecsElapsed());
+    if(wordList.isEmpty())
+    {
+        functionAndCandidateArea->setCurrentWidget(functionArea);
+        return;
+    }
+    for(int i=0;i<wordList.size();i++)
+    {
+        hanzi.prepend(wordList.at(i));
+    }
+    showCandidateArea();
+    displayCandidateWord();
+}
+/*
+ *@brief:   英文输入时提交候选单词。正在输入的单词已插入编辑框，删除后插入选择的单词和空格，
+ * 然后联想下一个单词
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   word:选择的单词
+ */
+void SoftKeyboard::commitEnglishWord(QString word)
+{
+    if(textBeforeCursor().endsWith(englishWord))
+    {
+        for(int i=0;i<englishWord.length();i++)
+        {
+            backspaceText();
+        }
+    }
+    insertText(word+" ");
+    englishWord.clear();
+    previousEnglishWord = word;
+    matchEnglish();
+}
+/*
+ *@brief:   九宫格输入时查找数字串对应的拼音，默认选择可能性最高的拼音匹配中文
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::matchT9()
+{
+    t9Spellings = t9Index.decode(t9Digits,MAXT9SPELLINGS);
+    t9SpellingIndex = 0;
+    showT9Spelling();
+}
+/*
+ *@brief:   笔画输入时查找笔画前缀对应的字词，已输入的笔画显示在候选字母框中
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::matchStroke()
+{
+    showCandidateArea();
+    candidateLetter->setText(StrokeIndex::toGlyphs(strokeSequence));
+    QElapsedTimer matchTimer;
+    matchTimer.start();
+    hanzi.clear();
+    snippetCandidates.clear();
+    QStringList wordList = strokeIndex.match(strokeSequence,MAXSTROKECANDIDATES);
+    for(int i=0;i<wordList.size();i++)
+    {
+        hanzi.prepend(wordList.at(i));//常用的在列表后面
+    }
+    matchHistogram.add(matchTimer.nsecsElapsed());
+    displayCandidateWord();
+}
+/*
+ *@brief:   按当前选择的拼音显示候选词，拼音显示在候选字母框中，提交候选词时按该拼音记录到
+ * 用户词典。数字串没有对应的拼音时显示数字串本身
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::showT9Spelling()
+{
+    showCandidateArea();
+    if(t9Spellings.isEmpty())
+    {
+        candidateLetter->setText(t9Digits);
+        hanzi.clear();
+        t9SpellingBtn->setText(QString::fromUtf8("拼音"));
+    }
+    else
+    {
+        candidateLetter->setText(t9Spellings.at(t9SpellingIndex));
+        matchChinese(t9Spellings.at(t9SpellingIndex));
+        t9SpellingBtn->setText(QString::fromUtf8("拼音 %1/%2").arg(t9SpellingIndex+1).arg(t9Spellings.size()));
+    }
+    displayCandidateWord();
+}
+/*
+ *@brief:   隐藏中文输入的候选区域
+ *@author:  缪庆瑞
+ *@date:    2017.1.4
+ */
+void SoftKeyboard::hideCandidateArea()
+{
+    pinyinMatchTimer->stop();
+    if(candidateLetter)
+    {
+        candidateLetter->clear();//清空候选字母
+    }
+    englishWord.clear();
+    previousEnglishWord.clear();
+    t9Digits.clear();
+    t9Spellings.clear();
+    strokeSequence.clear();
+    functionAndCandidateArea->setCurrentWidget(functionArea);//显示功能区
+}
+/*
+ *@brief:   向当前输入部件插入文字。设置了组合输入目标时以提交文本的形式发送，
+ * 同时结束目标部件中的预编辑
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   text:插入的文字
+ */
+void SoftKeyboard::insertText(const QString &text)
+{
+    if(inputTarget)
+    {
+        QInputMethodEvent event;
+        event.setCommitString(text);
+        QCoreApplication::sendEvent(inputTarget,&event);
+    }
+    else
+    {
+        currentLineEdit->insert(text);
+    }
+}
+/*
+ *@brief:   删除当前输入部件光标前的一个字符。组合输入时以替换光标前一个字符为空的提交文本实现
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::backspaceText()
+{
+    if(inputTarget)
+    {
+        QInputMethodEvent event;
+        event.setCommitString(QString(),-1,1);
+        QCoreApplication::sendEvent(inputTarget,&event);
+    }
+    else
+    {
+        currentLineEdit->backspace();
+    }
+}
+/*
+ *@brief:   向组合输入目标发送预编辑文本，带下划线，光标在末尾
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   text:预编辑文本，为空时清除预编辑
+ */
+void SoftKeyboard::updatePreedit(const QString &text)
+{
+    if(!inputTarget)
+    {
+        return;
+    }
+    QTextCharFormat format;
+    format.setFontUnderline(true);
+    QList<QInputMethodEvent::Attribute> attributeList;
+    attributeList<<QInputMethodEvent::Attribute(QInputMethodEvent::TextFormat,0,text.length(),format)
+                 <<QInputMethodEvent::Attribute(QInputMethodEvent::Cursor,text.length(),1,QVariant());
+    QInputMethodEvent event(text,attributeList);
+    QCoreApplication::sendEvent(inputTarget,&event);
+}
+/*
+ *@brief:   当前输入部件光标前的文本，组合输入时通过输入法查询获取
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+QString SoftKeyboard::textBeforeCursor() const
+{
+    if(inputTarget)
     {
-        thirdRowHLayout->addWidget(numberLetterBtn[i]);
+        QString surroundingText = inputTarget->inputMethodQuery(Qt::ImSurroundingText).toString();
+        return surroundingText.left(inputTarget->inputMethodQuery(Qt::ImCursorPosition).toInt());
     }
-    //布局第四排按键
-    QHBoxLayout *fourthRowHLayout = new QHBoxLayout();
-    fourthRowHLayout->addWidget(upperOrLowerBtn);//大小写切换按键
-    for(int i =29;i<36;i++)
+    return currentLineEdit->text().left(currentLineEdit->cursorPosition());
+}
+/*
+ *@brief:   当前输入部件，组合输入时为目标部件，否则为当前编辑框
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+QWidget *SoftKeyboard::currentInputWidget() const
+{
+    if(inputTarget)
     {
-        fourthRowHLayout->addWidget(numberLetterBtn[i]);
+        return inputTarget;
     }
-    fourthRowHLayout->addWidget(deleteBtn);//删除按键
-    //布局第五排按键，基本为特殊功能按键
-    QHBoxLayout *fifthRowHLayout = new QHBoxLayout();
-    fifthRowHLayout->addWidget(skinBtn,2);
-    fifthRowHLayout->addWidget(letterOrSymbolBtn,1);
-    fifthRowHLayout->addWidget(commaBtn,1);
-    fifthRowHLayout->addWidget(spaceBtn,4);
-    fifthRowHLayout->addWidget(periodBtn,1);
-    fifthRowHLayout->addWidget(chOrEnBtn,1);
-    fifthRowHLayout->addWidget(enterBtn,2);
-
-    keysArea = new QWidget();
-    QVBoxLayout *vBoxlayout = new QVBoxLayout(keysArea);
-    vBoxlayout->setContentsMargins(8,2,8,8);
-    vBoxlayout->addLayout(firstRowHLayout);
-    vBoxlayout->addLayout(secondRowHLayout);
-    vBoxlayout->addLayout(thirdRowHLayout);
-    vBoxlayout->addLayout(fourthRowHLayout);
-    vBoxlayout->addLayout(fifthRowHLayout);
+    return currentLineEdit;
 }
 /*
- *@brief:   读拼音字典，将汉字与对应拼音存放到hash表中,也可以是QMap中，但不考虑排列顺序时，hash更快
+ *@brief:   更新接收实体键盘按键的部件，事件过滤器随当前输入部件移动
  *@author:  缪庆瑞
- *@date:    2020.05.09
+ *@date:    2026.10.19
  */
-void SoftKeyboard::readDictionary()
+void SoftKeyboard::updateKeyEventSource()
 {
-    //通过打印时间测试读拼音文件的效率 8G内存windows测试大约用1/10s
-    qDebug()<<QDateTime::currentDateTime().toString("yyyy-MM-dd HH:m:s:z");
-    QFile pinyinFile(PINYINFILEPATH);
-    if(!pinyinFile.open(QIODevice::ReadOnly))//拼音文件打开失败提示
+    QWidget *source = isPhysicalKeyboard?currentInputWidget():NULL;
+    if(source == keyEventSource)
     {
-        QMessageBox::critical(this,"Open File Failed",QString::fromUtf8("无法打开拼音文件。。。"));
+        return;
     }
-    else
+    if(keyEventSource)
     {
-        QRegExp regExp("[a-z']+");//正则表达式，匹配1个或多个由a-z及 ' 组成的字母串，默认区分大小写
-        QString lineText;//存放读取的一行数据 汉字-拼音
-        QString linePinyin;//存放正则表达式匹配的拼音
-        QString lineChinese;//存放拼音对应的汉字
-        int pinyinPosition;//每一行匹配拼音的位置
-        while(!pinyinFile.atEnd())//while循环读取拼音文件，直到读完
-        {
-            lineText = QString(QString::fromUtf8(pinyinFile.readLine()));
-            pinyinPosition=regExp.indexIn(lineText,0);//获取读取行的文本中匹配正则表达式的位置
-            linePinyin = regExp.cap(0);//regExp.cap(0)表示完整正则表达式的匹配
-            lineChinese = lineText.left(pinyinPosition);//lineText.left(n)可以获取左边那个字符即对应的汉字
-            if(linePinyin.contains("'"))//如果有单引号表示是词组，则进行拆分词组
-            {
-                splitPhrase(linePinyin,lineChinese);
-            }
-            else//单个汉字
-            {
-                chinesePinyin.insert(linePinyin,lineChinese);//往哈希表插入键值对
-            }
-        }
+        keyEventSource->removeEventFilter(this);
+    }
+    keyEventSource = source;
+    if(source)
+    {
+        source->installEventFilter(this);
     }
-    qDebug()<<QDateTime::currentDateTime().toString("yyyy-MM-dd HH:m:s:z");
-    //qDebug()<<chinesePinyin.size();
 }
 /*
- *@brief:   拆分拼音词组，拼音字典文件词组用'分割，如"ai'qing"该函数的功能便是去掉'，
- * 将简拼、全拼存放到哈希表中
+ *@brief:   处理实体键盘的按键。中文输入时小写字母组成拼音；正在输入拼音时空格、数字、退格、
+ * 回车、Esc用于选词及编辑拼音。拼音的改变只记录，匹配和候选条的刷新合并到时间窗口结束时
+ * 进行，按键快于界面刷新时不会为中间的拼音做无用的查询。带Ctrl/Alt等修饰键的按键及英文
+ * 输入的按键不处理，由输入部件自行处理
  *@author:  缪庆瑞
- *@date:    2017.2.7
- *@param:   phrase:要处理的拼音词组
- *@param:   chinese:拼音对应的汉字
+ *@date:    2026.10.19
+ *@param:   event:按键事件
+ *@return:  按键已处理返回true
  */
-void SoftKeyboard::splitPhrase(QString phrase,QString chinese)
+bool SoftKeyboard::processPhysicalKey(QKeyEvent *event)
 {
-    int count = phrase.count("'");
-    if(count==1)//两个汉字
+    if(event->modifiers() & (Qt::ControlModifier|Qt::AltModifier|Qt::MetaModifier))
     {
-        int index=phrase.indexOf("'");
-        QString pinyin1=phrase.left(1);//两字首字母简拼 例aq
-        pinyin1.append(phrase.at(index+1));
-        chinesePinyin.insert(pinyin1,chinese);
-        QString pinyin2=phrase.left(index);//全拼+首字母 aiq
-        pinyin2.append(phrase.at(index+1));
-        if(pinyin2!=pinyin1)//避免同一词组键值对插入哈希表多次 例如 e'xi
-        {
-            chinesePinyin.insert(pinyin2,chinese);
-        }
-        QString pinyin3=phrase.remove("'");//全拼 aiqing
-        if(pinyin3!=pinyin2)
-        {
-             chinesePinyin.insert(pinyin3,chinese);
-        }
+        return false;
     }
-    else if(count==2)//三个汉字
+    if(isStrokeMode)//笔画输入只使用屏幕按键
     {
-        int index1=phrase.indexOf("'");
-        int index2=phrase.indexOf("'",index1+1);
-        QString pinyin1=phrase.left(1);//三字首字母简拼
-        pinyin1.append(phrase.at(index1+1));
-        pinyin1.append(phrase.at(index2+1));
-        chinesePinyin.insert(pinyin1,chinese);
-        QString pinyin2=phrase.left(index1);//全拼+首字母+首字母
-        pinyin2.append(phrase.at(index1+1));
-        pinyin2.append(phrase.at(index2+1));
-        if(pinyin2!=pinyin1)//避免同一词组键值对插入哈希表多次 例如 e'xi
-        {
-            chinesePinyin.insert(pinyin2,chinese);
-        }
-        QString pinyin3=phrase.left(index2);//全拼+全拼+首字母
-        pinyin3.append(phrase.at(index2+1));
-        pinyin3.remove("'");
-        if(pinyin3!=pinyin2)//避免同一词组键值对插入哈希表多次 例如 e'xi
+        return false;
+    }
+    bool isCandidateShown = (candidateArea && functionAndCandidateArea->currentWidget() == candidateArea);
+    if(isENInput)
+    {
+        if(isCandidateShown)//实体键盘输入的内容不经过补全流程，结束正在补全的单词
         {
-            chinesePinyin.insert(pinyin3,chinese);
+            hideCandidateArea();
         }
-        QString pinyin4=phrase.remove("'");//全拼
-        if(pinyin4!=pinyin3)//避免同一词组键值对插入哈希表多次 例如 e'xi
+        return false;
+    }
+    QString text = event->text();
+    if(text.length() == 1 && text.at(0) >= QLatin1Char('a') && text.at(0) <= QLatin1Char('z'))
+    {
+        if(isT9Mode && !t9Digits.isEmpty())//正在输入九宫格数字串
         {
-            chinesePinyin.insert(pinyin4,chinese);
+            return true;
         }
+        showCandidateArea();
+        candidateLetter->insert(text);
+        schedulePinyinMatch();
+        return true;
+    }
+    if(!isCandidateShown || candidateLetter->text().isEmpty())
+    {
+        return false;
     }
-    else if(count==3)//四个汉字
+    int key = event->key();
+    if(key >= Qt::Key_1 && key <= Qt::Key_9)
     {
-        int index1=phrase.indexOf("'");
-        int index2=phrase.indexOf("'",index1+1);
-        int index3=phrase.indexOf("'",index2+1);
-        QString pinyin1=phrase.left(1);//四字首字母简拼
-        pinyin1.append(phrase.at(index1+1));
-        pinyin1.append(phrase.at(index2+1));
-        pinyin1.append(phrase.at(index3+1));
-        chinesePinyin.insert(pinyin1,chinese);
-        QString pinyin2=phrase.left(index1);//全拼+首字母+首字母+首字母
-        pinyin2.append(phrase.at(index1+1));
-        pinyin2.append(phrase.at(index2+1));
-        pinyin2.append(phrase.at(index3+1));
-        if(pinyin2!=pinyin1)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        flushPinyinMatch();
+        QString word = candidateBar->candidate(candidateBar->firstVisibleIndex()+key-Qt::Key_1);
+        if(!word.isEmpty())
         {
-            chinesePinyin.insert(pinyin2,chinese);
+            commitCandidateWord(word);
         }
-        QString pinyin3=phrase.left(index2);//全拼+全拼+首字母+首字母
-        pinyin3.append(phrase.at(index2+1));
-        pinyin3.append(phrase.at(index3+1));
-        pinyin3.remove("'");
-        if(pinyin3!=pinyin2)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        return true;
+    }
+    switch(key)
+    {
+    case Qt::Key_Space:
+        spaceSlot();
+        return true;
+    case Qt::Key_Backspace:
+        if(isT9Mode && !t9Digits.isEmpty())
         {
-            chinesePinyin.insert(pinyin3,chinese);
+            deleteTextSlot();
+            return true;
         }
-        QString pinyin4=phrase.left(index3);//全拼+全拼+全拼+首字母
-        pinyin4.append(phrase.at(index3+1));
-        pinyin4.remove("'");
-        if(pinyin4!=pinyin3)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        candidateLetter->backspace();
+        if(candidateLetter->text().isEmpty())
         {
-            chinesePinyin.insert(pinyin4,chinese);
+            hideCandidateArea();
         }
-        QString pinyin5=phrase.remove("'");//全拼
-        if(pinyin5!=pinyin4)//避免同一词组键值对插入哈希表多次 例如 e'xing'xun'huan
+        else
         {
-            chinesePinyin.insert(pinyin5,chinese);
+            schedulePinyinMatch();
         }
+        return true;
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        enterSlot();
+        return true;
+    case Qt::Key_Escape:
+        hideCandidateArea();
+        return true;
+    default:
+        return false;
     }
 }
 /*
- *@brief:   根据输入的拼音匹配中文
+ *@brief:   拼音改变后等待时间窗口结束再匹配，窗口从第一次改变开始计时，连续按键时不会一直推迟
  *@author:  缪庆瑞
- *@date:    2017.1.1
- *@param:   pinyin:输入的拼音
+ *@date:    2026.10.19
  */
-void SoftKeyboard::matchChinese(QString pinyin)
+void SoftKeyboard::schedulePinyinMatch()
 {
-    hanzi.clear();//每次匹配中文都先清空之前的列表
-    //哈希表chinesePinyin中存放着拼音-汉字的键值对（一键多值），获取对应拼音的汉字列表
-    hanzi = chinesePinyin.values(pinyin);
-    //qDebug()<<hanzi;
-    pageCount = 1;//每次匹配，候选词初始化显示第一页
+    if(!pinyinMatchTimer->isActive())
+    {
+        pinyinMatchTimer->start();
+    }
 }
 /*
- *@brief:   显示指定页的候选词
+ *@brief:   立即完成等待中的拼音匹配，选词前调用，保证候选词与当前拼音一致
  *@author:  缪庆瑞
- *@date:    2017.1.1
- *@param:   page:指定页,从1开始
+ *@date:    2026.10.19
  */
-void SoftKeyboard::displayCandidateWord(int page)
+void SoftKeyboard::flushPinyinMatch()
 {
-    int hanziCount = hanzi.size();//匹配的汉字列表个数
-    if(page == 1)//当显示第一页时向前翻页按钮不可点击
-    {
-        prePageBtn->setEnabled(false);
-    }
-    else
-    {
-        prePageBtn->setEnabled(true);
-    }
-    if(page*CANDIDATEWORDNUM>=hanziCount)
-    {
-        nextPageBtn->setEnabled(false);
-    }
-    else
+    if(pinyinMatchTimer->isActive())
     {
-        nextPageBtn->setEnabled(true);
+        pinyinMatchTimer->stop();
+        pinyinMatchSlot();
     }
-    /*因为哈希表获取指定的key对应的值列表时,是按照后插入的先获取(后进先出),
-     * 所以常见字在后面,这里处理为从列表的最后一个反向获取显示
-     */
-    int num = hanziCount-1-(page-1)*CANDIDATEWORDNUM;
-    for(int i=0;i<CANDIDATEWORDNUM;i++)//每页默认6个候选字词
+}
+/*
+ *@brief:   定时输出运行统计，每项一行
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::statisticsLogSlot()
+{
+    QStringList lineList = runtimeStatistics().toString().split("\n");
+    for(int i=0;i<lineList.size();i++)
     {
-        if(num>=i)
-        {
-            candidateWordBtn[i]->setText(hanzi.at(num-i));
-            candidateWordBtn[i]->setEnabled(true);
-        }
-        else
-        {
-            candidateWordBtn[i]->setText(" ");//清除上一页的缓存
-            candidateWordBtn[i]->setEnabled(false);
-        }
+        qDebug("SoftKeyboard %s",qPrintable(lineList.at(i)));
     }
 }
 /*
- *@brief:   隐藏中文输入的候选区域
+ *@brief:   匹配连续按键后最终的拼音并显示候选词
  *@author:  缪庆瑞
- *@date:    2017.1.4
+ *@date:    2026.10.19
  */
-void SoftKeyboard::hideCandidateArea()
+void SoftKeyboard::pinyinMatchSlot()
 {
-    candidateLetter->clear();//清空候选字母
-    functionAndCandidateArea->setCurrentWidget(functionArea);//显示功能区
+    if(!candidateArea || functionAndCandidateArea->currentWidget() != candidateArea
+            || candidateLetter->text().isEmpty())
+    {
+        return;
+    }
+    matchChinese(candidateLetter->text());
+    displayCandidateWord();
 }
 /*
  *@brief:   中文输入时候选字母区域根据内容改变文本框的大小
@@ -725,6 +2138,11 @@ void SoftKeyboard::hideCandidateArea()
  */
 void SoftKeyboard::candidateLetterChangedSlot(QString text)
 {
+    if(inputTarget)//组合输入 拼音作为预编辑文本显示在目标部件中，候选区不需要重新布局
+    {
+        updatePreedit(text);
+        return;
+    }
     //根据输入的内容自动改变文本区域大小
     int width = candidateLetter->fontMetrics().width(text)+6;
     candidateLetter->setFixedWidth(width);
@@ -733,32 +2151,27 @@ void SoftKeyboard::candidateLetterChangedSlot(QString text)
  *@brief:   候选词被点击的响应槽
  *@author:  缪庆瑞
  *@date:    2016.12.25
+ *@param:   word:被点击的候选词
  */
-void SoftKeyboard::candidateWordBtnSlot()
-{
-    QToolButton *clickedBtn = qobject_cast<QToolButton *>(sender());//获取信号发送者的对象
-    currentLineEdit->insert(clickedBtn->text());
-    hideCandidateArea();//隐藏中文候选区域
-}
-/*
- *@brief:   候选词向前翻页
- *@author:  缪庆瑞
- *@date:    2016.12.29
- */
-void SoftKeyboard::candidateWordPrePageSlot()
+void SoftKeyboard::candidateWordClickedSlot(QString word)
 {
-    pageCount--;
-    this->displayCandidateWord(pageCount);
+    commitCandidateWord(word);
 }
 /*
- *@brief:   候选词向后翻页
+ *@brief:   候选条需要更多候选词时获取下一批。候选词列表中常用的在后面，从列表末尾反向获取
  *@author:  缪庆瑞
- *@date:    2016.12.29
+ *@date:    2026.10.19
  */
-void SoftKeyboard::candidateWordNextPageSlot()
+void SoftKeyboard::fetchCandidateWordSlot()
 {
-    pageCount++;
-    this->displayCandidateWord(pageCount);
+    QStringList candidateList;
+    int num = hanzi.size()-1-fetchedCandidateCount;
+    for(int i=0;i<CANDIDATEFETCHNUM && num-i>=0;i++)
+    {
+        candidateList.append(hanzi.at(num-i));
+    }
+    fetchedCandidateCount += candidateList.size();
+    candidateBar->appendCandidates(candidateList,fetchedCandidateCount<hanzi.size());
 }
 /*
  *@brief:   字母(符号)按键被点击的响应槽
@@ -773,19 +2186,38 @@ void SoftKeyboard::numberLetterBtnSlot()
     {
         if(clickedBtn->text()=="&&")//因为可显示控件把&符号当成快捷键标志，一个不显示，所以这个要做下特别处理
         {
-            currentLineEdit->insert("&");
+            insertText("&");
         }
         else
         {
-            currentLineEdit->insert(clickedBtn->text());//文本输入框插入字母或符号
+            insertText(clickedBtn->text());//文本输入框插入字母或符号
+        }
+        if(englishCompleter.isEmpty())
+        {
+            return;
+        }
+        if(clickedBtn->text().length()==1 && clickedBtn->text().at(0).isLetter())//字母 补全正在输入的单词
+        {
+            previousEnglishWord.clear();
+            englishWord.append(clickedBtn->text());
+            matchEnglish();
+        }
+        else//数字或符号结束单词，没有补全结果时候选区已隐藏，同样要清空正在输入的单词
+        {
+            englishWord.clear();
+            previousEnglishWord.clear();
+            if(functionAndCandidateArea->currentWidget() == candidateArea)
+            {
+                hideCandidateArea();
+            }
         }
     }
     else  //中文输入模式 键入的字母放在第二部分输入显示区域的候选字母按钮上
     {
-        functionAndCandidateArea->setCurrentWidget(candidateArea);
+        showCandidateArea();
         candidateLetter->insert(clickedBtn->text());//候选字母输入框插入字母
         this->matchChinese(candidateLetter->text());//匹配中文
-        this->displayCandidateWord(pageCount);//显示候选词，默认第一页
+        this->displayCandidateWord();//显示候选词
     }
 }
 /*
@@ -825,7 +2257,44 @@ void SoftKeyboard::changeUpperLowerSlot()
  */
 void SoftKeyboard::deleteTextSlot()
 {
-    if(functionAndCandidateArea->currentWidget() == candidateArea)
+    if(isT9Mode && !t9Digits.isEmpty())//九宫格输入 删除最后一个数字
+    {
+        t9Digits.chop(1);
+        if(t9Digits.isEmpty())
+        {
+            hideCandidateArea();
+        }
+        else
+        {
+            matchT9();
+        }
+    }
+    else if(isStrokeMode && !strokeSequence.isEmpty())//笔画输入 删除最后一个笔画
+    {
+        strokeSequence.chop(1);
+        if(strokeSequence.isEmpty())
+        {
+            hideCandidateArea();
+        }
+        else
+        {
+            matchStroke();
+        }
+    }
+    else if(isENInput)//英文输入 删除编辑框内容，同时更新补全
+    {
+        backspaceText();
+        if(!englishWord.isEmpty())
+        {
+            englishWord.chop(1);
+            matchEnglish();
+        }
+        else if(functionAndCandidateArea->currentWidget() == candidateArea)
+        {
+            hideCandidateArea();
+        }
+    }
+    else if(functionAndCandidateArea->currentWidget() == candidateArea)
     {
         candidateLetter->backspace();//删除选中文本或光标前的一个字符，默认光标在最后
         if(candidateLetter->text().isEmpty())//删完了
@@ -835,12 +2304,12 @@ void SoftKeyboard::deleteTextSlot()
         else
         {
             matchChinese(candidateLetter->text());//重新匹配拼音
-            displayCandidateWord(pageCount);//显示候选词
+            displayCandidateWord();//显示候选词
         }
     }
     else
     {
-        currentLineEdit->backspace();
+        backspaceText();
     }
 }
 /*
@@ -897,14 +2366,21 @@ void SoftKeyboard::changeLetterSymbolSlot()
  */
 void SoftKeyboard::spaceSlot()
 {
-    if(functionAndCandidateArea->currentWidget() == candidateArea)
+    flushPinyinMatch();//第一个候选词需对应当前的拼音
+    if(isENInput)//英文输入 空格结束正在输入的单词，联想下一个单词
     {
-        currentLineEdit->insert(candidateWordBtn[0]->text());
-        hideCandidateArea();
+        insertText(" ");
+        previousEnglishWord = englishWord;
+        englishWord.clear();
+        matchEnglish();
+    }
+    else if(functionAndCandidateArea->currentWidget() == candidateArea)
+    {
+        commitCandidateWord(candidateBar->candidate(0));
     }
     else
     {
-        currentLineEdit->insert(" ");//插入一个空格
+        insertText(" ");//插入一个空格
     }
 }
 /*
@@ -914,6 +2390,7 @@ void SoftKeyboard::spaceSlot()
  */
 void SoftKeyboard::changeChEnSlot()
 {
+    hideCandidateArea();//中英文的候选内容不同，切换时隐藏
     if(isENInput)
     {
         isENInput = false;//切换为中文输入
@@ -948,14 +2425,17 @@ void SoftKeyboard::changeChEnSlot()
  */
 void SoftKeyboard::enterSlot()
 {
-    if(!candidateLetter->text().isEmpty())//候选字母非空，则将字母插入到编辑框里
+    if(candidateLetter && !candidateLetter->text().isEmpty())//候选字母非空，则将字母插入到编辑框里
     {
-        currentLineEdit->insert(candidateLetter->text());
+        if(!isStrokeMode)//笔画只用于查找，不插入
+        {
+            insertText(candidateLetter->text());
+        }
         hideCandidateArea();
     }
     else
     {
-        if(inputBufferArea->isVisible())//输入缓存区显示时，将缓存的内容通过信号发送出去
+        if(inputBufferArea->isVisible() && inputContentEdit)//输入缓存区显示时，将缓存的内容通过信号发送出去
         {
             emit sendInputBufferAreaText(inputContentEdit->text());
         }
@@ -971,6 +2451,229 @@ void SoftKeyboard::clearAndCloseSlot()
 {
     showInputBufferArea();//显示输入缓存区
     hideCandidateArea();//隐藏候选区
+    userDictionary->flush();//关闭键盘时将用户词典记录交给写线程，不必等待定时器
     disconnect(this,0,0,0);//断开键盘所有的信号与槽连接
     this->close();
 }
+/*
+ *@brief:   字典文件改变响应槽。记录改变的文件，延时后统一重新加载
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   path:改变的文件路径
+ */
+void SoftKeyboard::dictionaryFileChangedSlot(QString path)
+{
+    if(!pendingReloadPaths.contains(path))
+    {
+        pendingReloadPaths.append(path);
+    }
+    dictionaryReloadTimer->start();//重新计时，文件连续改变时只加载一次
+}
+/*
+ *@brief:   在后台线程依次重新加载改变的字典文件，正在加载时等本次加载完成后再继续。
+ * 部署工具常以重命名替换文件，此时监视会失效，这里重新添加
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::reloadDictionarySlot()
+{
+    QStringList pathList = layeredDictionary.layerFilePaths();
+    for(int i=0;i<pathList.size();i++)
+    {
+        if(!dictionaryWatcher->files().contains(pathList.at(i)) && QFile::exists(pathList.at(i)))
+        {
+            dictionaryWatcher->addPath(pathList.at(i));
+        }
+    }
+    if(dictionaryReloadWatcher->isRunning() || pendingReloadPaths.isEmpty())
+    {
+        return;
+    }
+    reloadingFilePath = pendingReloadPaths.takeFirst();
+    reloadElapsedTimer.start();
+    dictionaryReloadWatcher->setFuture(QtConcurrent::run(loadSharedDictionary,reloadingFilePath));
+}
+/*
+ *@brief:   字典加载完成，在界面线程替换该文件对应的字典层。替换只是一次指针赋值，发生在两次
+ * 按键之间，输入过程中不会被阻塞也不会看到构建了一半的字典
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::dictionaryReloadedSlot()
+{
+    QSharedPointer<const DictionaryIndex> dictionary = dictionaryReloadWatcher->result();
+    if(dictionary.isNull())
+    {
+        qDebug()<<"dictionaryReloadedSlot():Failed to reload"<<reloadingFilePath;
+    }
+    else if(layeredDictionary.replaceFileLayers(reloadingFilePath,dictionary) > 0)
+    {
+        if(layeredDictionary.layer(SYSTEMLAYERNAME) == dictionary)
+        {
+            dictionaryLoadNsecs = reloadElapsedTimer.nsecsElapsed();//运行统计报告最近一次加载的耗时
+        }
+        dictionaryLayersChanged();
+    }
+    reloadingFilePath.clear();
+    if(!pendingReloadPaths.isEmpty())
+    {
+        reloadDictionarySlot();
+    }
+}
+/*
+ *@brief:   拼音纠错字典树构建完成，替换原有的字典树。构建期间字典又被替换时重新构建
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::correctorBuiltSlot()
+{
+    PinyinCorrector corrector = correctorBuildWatcher->result();
+    corrector.setMaxDistance(pinyinCorrector.maxDistance());//构建期间可能修改了设置
+    pinyinCorrector = corrector;
+    if(correctorGeneration != dictionaryGeneration && isTypoCorrection)
+    {
+        buildCorrectorAsync();
+    }
+}
+/*
+ *@brief:   九宫格数字按键被点击的响应槽。2~9追加到数字串并重新查找拼音；
+ * 1在没有输入数字串时插入中文逗号
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::t9DigitBtnSlot()
+{
+    QToolButton *clickedBtn = qobject_cast<QToolButton *>(sender());//获取信号发送者的对象
+    int digit = clickedBtn->text().at(0).digitValue();
+    if(digit == 1)
+    {
+        if(t9Digits.isEmpty())
+        {
+            insertText(QString::fromUtf8("，"));
+        }
+        return;
+    }
+    t9Digits.append(QChar('0'+digit));
+    matchT9();
+}
+/*
+ *@brief:   切换九宫格数字串对应的拼音，依次循环
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::t9SpellingSlot()
+{
+    if(t9Spellings.size() < 2)
+    {
+        return;
+    }
+    t9SpellingIndex = (t9SpellingIndex+1)%t9Spellings.size();
+    showT9Spelling();
+}
+/*
+ *@brief:   九宫格数字串索引构建完成，替换原有的索引。构建期间字典又被替换时重新构建，
+ * 正在输入的数字串按新索引重新查找
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::t9IndexBuiltSlot()
+{
+    t9Index = t9BuildWatcher->result();
+    if(t9Generation != dictionaryGeneration && isT9Mode)
+    {
+        buildT9IndexAsync();
+    }
+    if(isT9Mode && !t9Digits.isEmpty())
+    {
+        matchT9();
+    }
+}
+/*
+ *@brief:   笔画键被点击的响应槽，逗号键在没有输入笔画时插入逗号
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::strokeBtnSlot()
+{
+    QToolButton *clickedBtn = qobject_cast<QToolButton *>(sender());//获取信号发送者的对象
+    if(clickedBtn == strokeCommaBtn)
+    {
+        if(strokeSequence.isEmpty())
+        {
+            insertText(QString::fromUtf8("，"));
+        }
+        return;
+    }
+    for(int i=0;i<5;i++)
+    {
+        if(clickedBtn == strokeBtn[i])
+        {
+            strokeSequence.append(char('1'+i));
+            matchStroke();
+            return;
+        }
+    }
+}
+/*
+ *@brief:   笔画索引构建完成，替换原有的索引。构建期间字典又被替换时重新构建，
+ * 正在输入的笔画按新索引重新查找
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::strokeIndexBuiltSlot()
+{
+    strokeIndex = strokeBuildWatcher->result();
+    if(strokeGeneration != dictionaryGeneration && isStrokeMode)
+    {
+        buildStrokeIndexAsync();
+    }
+    if(isStrokeMode && !strokeSequence.isEmpty())
+    {
+        matchStroke();
+    }
+}
+/*
+ *@brief:   空闲时预先渲染当前皮肤下的按键文字和最常用的候选字(每个单字母拼音排在最前的
+ * 几个字)，使按键第一次显示及首次输入时只需要贴图。按键先应用样式表，保证字体、颜色与
+ * 绘制时一致
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void SoftKeyboard::warmTextCacheSlot()
+{
+    QList<QToolButton *> keyBtnList;
+    for(int i=0;i<36;i++)
+    {
+        keyBtnList.append(numberLetterBtn[i]);
+    }
+    for(int i=0;i<10;i++)
+    {
+        keyBtnList.append(t9DigitBtn[i]);
+    }
+    for(int i=0;i<5;i++)
+    {
+        keyBtnList.append(strokeBtn[i]);
+    }
+    for(int i=0;i<keyBtnList.size();i++)
+    {
+        QToolButton *keyBtn = keyBtnList.at(i);
+        keyBtn->ensurePolished();
+        textPixmapCache.warmUp(QStringList()<<keyBtn->text().replace("&&","&"),keyBtn->font(),
+                               keyBtn->palette().color(QPalette::Active,QPalette::ButtonText));
+    }
+    QStringList frequentWordList;
+    for(char letter='a';letter<='z';letter++)
+    {
+        QList<QString> wordList = layeredDictionary.values(QString(QChar(letter)));
+        for(int i=wordList.size()-1;i>=0 && i>=wordList.size()-WARMUPCANDIDATENUM;i--)//常用的字在后面
+        {
+            frequentWordList.append(wordList.at(i));
+        }
+    }
+    if(candidateBar)//候选区还未创建时，在创建后再预先渲染
+    {
+        candidateBar->ensurePolished();
+        textPixmapCache.warmUp(frequentWordList,candidateBar->font(),
+                               candidateBar->palette().color(QPalette::Active,QPalette::WindowText));
+    }
+}
@@ -21,9 +21,31 @@
 #include <QMessageBox>
 #include <QStackedWidget>
 #include <QMouseEvent>
+#include <QShowEvent>
+#include <QKeyEvent>
 #include <QPoint>
-
-#define CANDIDATEWORDNUM 6   //默认候选词数量
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QPointer>
+#include "pinyindictionary.h"
+#include "layereddictionary.h"
+#include "sentencedecoder.h"
+#include "userdictionary.h"
+#include "fuzzypinyin.h"
+#include "pinyincorrector.h"
+#include "compresseddictionary.h"
+#include "englishcompleter.h"
+#include "t9index.h"
+#include "textpixmapcache.h"
+#include "candidatebar.h"
+#include "touchkeyinput.h"
+#include "snippettable.h"
+#include "strokeindex.h"
+#include "latencyhistogram.h"
+#include "runtimestatistics.h"
 
 class SoftKeyboard : public QWidget
 {
@@ -37,40 +59,101 @@ public:
     void setMoveEnabled(bool moveEnabled=true);//设置无边框窗口移动使能
     void showInputBufferArea(QString inputTitle=QString("Please input"),QString inputContent=QString());//显示输入缓存区域
     void hideInputBufferArea(QLineEdit *currLineEdit);//隐藏输入缓存区域
+    void setInputTarget(QWidget *target);//设置组合输入的目标部件，预编辑及提交通过输入法事件发送
+    void setSentenceModeEnabled(bool enabled=true);//设置整句输入模式使能
+    void setFuzzyPinyin(int mask,int maxVariants=16);//设置模糊音规则，mask为FuzzyPinyin::FuzzyFlag组合
+    FuzzyPinyin::Statistics fuzzyPinyinStatistics() const;//模糊音查询开销统计
+    void setTypoCorrectionEnabled(bool enabled=true,int maxDistance=1);//设置拼音纠错使能
+    PinyinCorrector::Statistics typoCorrectionStatistics() const;//拼音纠错开销统计
+    //分层字典 系统字典之外可以添加领域字典，各层合并查询
+    bool addDictionaryLayer(const QString &name,const QString &filePath,int rankBias=0);//加载字典文件作为一层
+    void addDictionaryLayer(const QString &name,QSharedPointer<const DictionaryIndex> index,int rankBias=0);//共享已有的字典
+    bool removeDictionaryLayer(const QString &name);//卸载一层字典
+    QSharedPointer<const DictionaryIndex> dictionaryLayer(const QString &name) const;//获取一层字典，可共享给其他键盘
+    void setUserDictionaryPath(const QString &filePath);//设置用户词典路径，多个键盘同时使用时各自记录
+    void setDictionaryMemoryBudget(int bytes);//设置压缩字典页面缓存的内存预算
+    CompressedDictionary::Statistics dictionaryResidencyStatistics() const;//压缩字典页面驻留统计
+    bool loadEnglishWords(const QString &filePath);//加载英文词频表，用于英文补全及联想
+    EnglishCompleter::Statistics englishCompletionStatistics() const;//英文补全开销统计
+    bool loadSnippets(const QString &filePath);//加载短语表，编码对应的常用文本显示在候选条中
+    SnippetTable::Statistics snippetStatistics() const;//短语查询开销统计
+    void setT9ModeEnabled(bool enabled=true);//设置九宫格拼音输入使能
+    T9Index::Statistics t9Statistics() const;//九宫格数字串查询开销统计
+    bool setStrokeModeEnabled(bool enabled=true);//设置笔画输入使能
+    StrokeIndex::Statistics strokeStatistics() const;//笔画查询开销统计
+    void setTextCacheSize(int bytes);//设置按键及候选词文字图片缓存的大小
+    TextPixmapCache::Statistics textCacheStatistics() const;//文字图片缓存统计
+    void setPressCommitEnabled(bool enabled=true);//设置触摸按键按下即提交
+    void setKeyPreviewEnabled(bool enabled=true);//设置触摸按键预览
+    TouchKeyInput::Statistics touchInputStatistics() const;//触摸输入统计，含事件到提交的耗时
+    void setPhysicalKeyboardEnabled(bool enabled=true);//设置实体键盘输入使能
+    RuntimeStatistics runtimeStatistics() const;//运行统计快照
+    void resetRuntimeStatistics();//清零按键耗时及各模块开销统计
+    void setStatisticsLogInterval(int msecs);//定时输出运行统计到日志，0为关闭
 
 protected:
     //通过这三个事件处理函数实现无边框窗口的移动
     void mousePressEvent(QMouseEvent *event);
     void mouseMoveEvent(QMouseEvent *event);
     void mouseReleaseEvent(QMouseEvent *event);
+    void showEvent(QShowEvent *event);
+    //实体键盘输入
+    void keyPressEvent(QKeyEvent *event);
+    bool eventFilter(QObject *watched,QEvent *event);
 
 private:
     void initStyleSheet();//初始化可选样式表，用于不同的皮肤展示
     void initNumberLetterBtn();//初始化数字字母按键
     void initSpecialBtn();//初始化特殊功能按键
+    static QStringList letterLowList();//数字及小写字母按键的文本
     void setLetterLow();//设置小写字母显示
     void setLetterUpper();//设置大写字母显示
     void setSymbolsEN();//设置符号（英文状态）
     void setSymbolsCH();//设置符号（中文状态）
 
     void initInputBufferArea();//初始化输入缓存区
+    void ensureInputBufferArea();//创建输入缓存区的标题和编辑框
     void initFunctionAndCandidateArea();//初始化功能和候选区域
+    void ensureCandidateArea();//创建候选区
+    void showCandidateArea();//显示候选区
     void initKeysArea();//初始化按键区域
+    void initT9KeysArea();//初始化九宫格按键区域
+    void initStrokeKeysArea();//初始化笔画输入按键区域
 
     void readDictionary();//读拼音字典，将汉字与拼音的对应存放到hash表中
-    void splitPhrase(QString phrase,QString chinese);//拆分拼音词组
+    void initDictionaryReload();//初始化字典文件监视，文件改变时后台重新加载
+    void resetSentenceDecoder();//由当前字典重置整句解码器
+    void buildCorrectorAsync();//后台构建拼音纠错字典树
+    void buildT9IndexAsync();//后台构建九宫格数字串索引
+    void buildStrokeIndexAsync();//后台构建笔画索引
+    void dictionaryLayersChanged();//字典层改变后更新解码器、纠错字典树及候选词
     void matchChinese(QString pinyin);//根据输入的拼音匹配中文
-    void displayCandidateWord(int page);//显示指定页的候选词
+    void appendLowRankCandidates(const QStringList &pinyinList);//追加排在已有候选词之后的候选词
+    void displayCandidateWord();//在候选条中显示候选词
+    void commitCandidateWord(QString word);//提交候选词，并记录到用户词典
+    void matchEnglish();//英文输入时补全当前单词或联想下一个单词
+    void commitEnglishWord(QString word);//用选择的单词替换正在输入的单词
+    void matchT9();//九宫格输入时查找数字串对应的拼音并匹配中文
+    void matchStroke();//笔画输入时查找笔画前缀对应的字词
+    void showT9Spelling();//按当前选择的拼音显示候选词
     void hideCandidateArea();//隐藏中文输入显示区域
+    void insertText(const QString &text);//向当前输入部件插入文字
+    void backspaceText();//删除当前输入部件光标前的一个字符
+    void updatePreedit(const QString &text);//向组合输入目标发送预编辑文本
+    QString textBeforeCursor() const;//当前输入部件光标前的文本
+    QWidget *currentInputWidget() const;//当前输入部件
+    void updateKeyEventSource();//更新接收实体键盘按键的部件
+    bool processPhysicalKey(QKeyEvent *event);//处理实体键盘的按键，已处理返回true
+    void schedulePinyinMatch();//合并连续按键，时间窗口结束时匹配拼音
+    void flushPinyinMatch();//立即完成等待中的拼音匹配
 
 signals:
     void sendInputBufferAreaText(QString text);//以信号的形式将输入缓存区文本发出去
 
 public slots:
     void candidateLetterChangedSlot(QString text);//候选字母改变响应槽
-    void candidateWordBtnSlot();//候选词被点击的响应槽
-    void candidateWordPrePageSlot();//候选词向前翻页
-    void candidateWordNextPageSlot();//候选词向后翻页
+    void candidateWordClickedSlot(QString word);//候选词被点击的响应槽
+    void fetchCandidateWordSlot();//获取下一批候选词
 
     void numberLetterBtnSlot();//数字字母(符号)按键被点击的响应槽
     void changeUpperLowerSlot();//切换大小写，也可以切换数字字母与符号界面
@@ -83,9 +166,77 @@ public slots:
 
     void clearAndCloseSlot();//清理并关闭键盘
 
+    void dictionaryFileChangedSlot(QString path);//字典文件改变响应槽
+    void reloadDictionarySlot();//后台重新加载字典
+    void dictionaryReloadedSlot();//字典加载完成，替换当前字典
+    void correctorBuiltSlot();//拼音纠错字典树构建完成
+
+    void t9DigitBtnSlot();//九宫格数字按键被点击的响应槽
+    void t9SpellingSlot();//切换九宫格数字串对应的拼音
+    void t9IndexBuiltSlot();//九宫格数字串索引构建完成
+    void strokeBtnSlot();//笔画键被点击的响应槽
+    void strokeIndexBuiltSlot();//笔画索引构建完成
+    void warmTextCacheSlot();//空闲时预先渲染按键文字及常用候选字
+    void lazyInitSlot();//空闲时创建延后的部件
+    void pinyinMatchSlot();//匹配连续按键后最终的拼音
+    void statisticsLogSlot();//定时输出运行统计
+
 private:
-    QMultiHash<QString,QString> chinesePinyin;//使用哈希表来存放拼音汉字的键值对 一键多值
-    QList<QString> hanzi;//存储匹配的汉字词
+    LayeredDictionary layeredDictionary;//分层字典，每层构建后只读，重新加载时整体替换该层
+    int dictionaryGeneration;//字典层每改变一次加1
+    qint64 dictionaryLoadNsecs;//最近一次加载系统字典的耗时(ns)
+    QElapsedTimer reloadElapsedTimer;//后台重新加载字典的计时
+    QFileSystemWatcher *dictionaryWatcher;//字典文件监视
+    QTimer *dictionaryReloadTimer;//文件改变后延时加载，合并短时间内的多次改变
+    QFutureWatcher<QSharedPointer<const DictionaryIndex> > *dictionaryReloadWatcher;
+    QString reloadingFilePath;//正在后台加载的字典文件
+    QStringList pendingReloadPaths;//等待重新加载的字典文件
+    QFutureWatcher<PinyinCorrector> *correctorBuildWatcher;
+    int correctorGeneration;//正在构建的纠错字典树对应的字典层版本
+    QFutureWatcher<T9Index> *t9BuildWatcher;
+    int t9Generation;//正在构建的九宫格索引对应的字典层版本
+    QFutureWatcher<StrokeIndex> *strokeBuildWatcher;
+    int strokeGeneration;//正在构建的笔画索引对应的字典层版本
+    QList<QString> hanzi;//存储匹配的汉字词，英文输入时存储补全的单词
+    //运行统计
+    LatencyHistogram matchHistogram;//每次按键匹配候选词的耗时
+    LatencyHistogram displayHistogram;//候选词填充候选条的耗时
+    QTimer *statisticsLogTimer;//定时输出运行统计
+    SentenceDecoder sentenceDecoder;//整句解码器，将完整的拼音串转换为句子
+    FuzzyPinyin fuzzyPinyin;//模糊音，查询时展开输入拼音
+    PinyinCorrector pinyinCorrector;//拼音纠错，按编辑距离搜索相近的拼音
+    UserDictionary *userDictionary;//用户词典，记录候选词权重及学习的词组
+    //组词学习 记录连续选择的候选词
+    QWidget *phraseChainEdit;//连续选词所在的输入部件
+    QString phraseChainText;//上次选词后输入部件光标前的内容，用于判断选词是否连续
+    QString phraseChainPinyin;//连续选词组成的拼音，用'分隔
+    QString phraseChainWord;//连续选词组成的汉字
+    QString phraseChainLastWord;//连续选词中上一次选择的词
+    QList<QPair<QString,QString> > learnedTransitionList;//连续选词学习到的相邻词对，重置解码器后重新加入
+    //英文补全
+    EnglishCompleter englishCompleter;//英文单词补全及联想
+    QString englishWord;//正在输入的英文单词(已插入编辑框)
+    QString previousEnglishWord;//上一个输入完成的英文单词，用于联想
+    //短语
+    SnippetTable snippetTable;//编码-常用文本表
+    QStringList snippetCandidates;//当前候选词中的短语
+    //九宫格输入
+    T9Index t9Index;//数字串-拼音索引
+    QString t9Digits;//已输入的数字串
+    QStringList t9Spellings;//数字串对应的拼音
+    int t9SpellingIndex;//当前选择的拼音
+    //笔画输入
+    StrokeIndex strokeIndex;//笔画前缀-字词索引
+    QByteArray strokeSequence;//已输入的笔画，由'1'~'5'组成
+    //文字图片缓存 按键及候选词重绘时直接贴图
+    TextPixmapCache textPixmapCache;
+    //触摸输入 直接处理按键区域的触摸事件，支持多指交替输入
+    TouchKeyInput *touchKeyInput;
+    QTimer *lazyInitTimer;//空闲时创建候选区及输入缓存区
+    //实体键盘输入
+    bool isPhysicalKeyboard;//实体键盘输入使能
+    QPointer<QWidget> keyEventSource;//安装了按键事件过滤器的输入部件
+    QTimer *pinyinMatchTimer;//合并连续按键的拼音匹配
 
     /***************各种状态变量***************/
     //模式
@@ -93,7 +244,11 @@ private:
     bool isLetterInput;//数字字母或符号输入模式
     bool isLetterLower;//大小写模式
     int skinNum;//当前皮肤编号
-    int pageCount;//候选词当前页
+    int fetchedCandidateCount;//候选条已获取的候选词个数
+    bool isSentenceMode;//整句输入模式
+    bool isT9Mode;//九宫格拼音输入模式
+    bool isStrokeMode;//笔画输入模式
+    bool isTypoCorrection;//拼音纠错使能
     //无边框窗口移动相关参数
     QPoint cursorGlobalPos;
     bool isMousePress;
@@ -105,6 +260,7 @@ private:
     QLabel *inputTitleLabel;
     QLineEdit *inputContentEdit;
     QLineEdit *currentLineEdit;//键盘当前的输入编辑框，可以接受外面传递的指针，默认为内置的inputContentEdit
+    QPointer<QWidget> inputTarget;//组合输入的目标部件，为空时直接向currentLineEdit插入文字
 
     /***********键盘功能及候选词区域************/
     QStackedWidget *functionAndCandidateArea;
@@ -112,13 +268,10 @@ private:
     //功能区  后期可以添加各种功能配置的入口按钮
     QWidget *functionArea;
     QLabel *introduceLabel;
-    //候选词区域 包括候选字母、候选词和翻页按钮
+    //候选词区域 包括候选字母和候选条
     QWidget *candidateArea;
     QLineEdit *candidateLetter;//中文输入时对应的字母显示
-    QWidget *candidateWordArea;
-    QToolButton *candidateWordBtn[CANDIDATEWORDNUM];//中文输入时的候选词
-    QToolButton *prePageBtn;//前一页
-    QToolButton *nextPageBtn;//后一页
+    CandidateBar *candidateBar;//候选词
 
     /***************键盘按键区域****************/
     QWidget *keysArea;//键盘的按键区域
@@ -135,6 +288,19 @@ private:
     QToolButton *periodBtn;//句号按键
     QToolButton *chOrEnBtn;//中英文切换按键
     QToolButton *enterBtn;//回车按键
+    //九宫格按键区域 面板较小时代替全键盘按键区域
+    QWidget *t9KeysArea;
+    QToolButton *t9DigitBtn[10];//数字键 1为标点，2~9对应字母，0为空格
+    QToolButton *t9DeleteBtn;
+    QToolButton *t9SpellingBtn;//切换拼音
+    QToolButton *t9EnterBtn;
+    //笔画输入按键区域
+    QWidget *strokeKeysArea;
+    QToolButton *strokeBtn[5];//笔画键 横竖撇点折
+    QToolButton *strokeCommaBtn;
+    QToolButton *strokeSpaceBtn;
+    QToolButton *strokeDeleteBtn;
+    QToolButton *strokeEnterBtn;
 
 };
 
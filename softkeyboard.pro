@@ -6,7 +6,7 @@
 
 QT       += core gui
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
 
 TARGET = softkeyboard
 TEMPLATE = app
@@ -14,11 +14,46 @@ TEMPLATE = app
 
 SOURCES += main.cpp\
     softkeyboard.cpp \
-    form.cpp
+    form.cpp \
+    pinyinsyllable.cpp \
+    sentencedecoder.cpp \
+    userdictionary.cpp \
+    fuzzypinyin.cpp \
+    pinyincorrector.cpp \
+    pinyindictionary.cpp \
+    layereddictionary.cpp \
+    compresseddictionary.cpp \
+    englishcompleter.cpp \
+    t9index.cpp \
+    textpixmapcache.cpp \
+    candidatebar.cpp \
+    touchkeyinput.cpp \
+    snippettable.cpp \
+    strokeindex.cpp \
+    latencyhistogram.cpp \
+    runtimestatistics.cpp
 
 HEADERS  += \
     softkeyboard.h \
-    form.h
+    form.h \
+    pinyinsyllable.h \
+    sentencedecoder.h \
+    userdictionary.h \
+    fuzzypinyin.h \
+    pinyincorrector.h \
+    pinyindictionary.h \
+    dictionaryindex.h \
+    layereddictionary.h \
+    compresseddictionary.h \
+    englishcompleter.h \
+    t9index.h \
+    textpixmapcache.h \
+    candidatebar.h \
+    touchkeyinput.h \
+    snippettable.h \
+    strokeindex.h \
+    latencyhistogram.h \
+    runtimestatistics.h
 
 FORMS += \
     form.ui
@@ -0,0 +1,367 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  笔画索引，由笔画表(汉字的笔顺)将拼音字典中的字词转换为笔画序列(1横2竖3撇4点5折)
+ * 后排序，按笔画前缀查找字词并按常用程度排序。一两笔的前缀对应数千个字，这些短前缀的
+ * 前K个结果在构建时预先排好，查询时直接取出
+ */
+#include "strokeindex.h"
+#include <QFile>
+#include <QRegExp>
+#include <QPair>
+#include <QElapsedTimer>
+#include <algorithm>
+
+#define MAXSTROKEWORDLENGTH 4       //参与笔画输入的最大词长
+#define PRECOMPUTEDSTROKES  2       //预排序结果的最大前缀笔画数
+#define PRECOMPUTEDTOPK     512     //每个短前缀预排序的结果个数
+
+//笔画1~5对应的显示字符 横竖撇点折
+static const char *const STROKE_GLYPHS = "一丨丿丶乛";
+
+//排名计算项 先按字数(单字在前)，再按常用程度
+struct RankItem
+{
+    int length;
+    double score;//字词在拼音候选列表中的相对位置，越小越常用
+    int index;
+};
+
+static bool lessRankItem(const RankItem &left,const RankItem &right)
+{
+    if(left.length != right.length)
+    {
+        return left.length < right.length;
+    }
+    return left.score < right.score;
+}
+/*
+ *@brief:   记录字词的常用程度，同一字词出现在多个拼音下时取最常用的位置
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+static void updateScore(QHash<QString,double> &scores,const QString &word,double score)
+{
+    QHash<QString,double>::iterator it = scores.find(word);
+    if(it == scores.end())
+    {
+        scores.insert(word,score);
+    }
+    else if(score < it.value())
+    {
+        it.value() = score;
+    }
+}
+
+/*遍历字典时记录字词常用程度的访问者，键长与字数相同(单字为声母、词组为简拼)的列表记入
+initialScores，其他列表记入otherScores*/
+class StrokeScoreVisitor : public DictionaryVisitor
+{
+public:
+    StrokeScoreVisitor(QHash<QString,double> &initial,QHash<QString,double> &other)
+        :initialScores(initial),otherScores(other)
+    {
+    }
+    void visit(const QString &pinyin,const QList<QString> &valueList)
+    {
+        int size = valueList.size();
+        for(int i=0;i<size;i++)
+        {
+            const QString &word = valueList.at(i);
+            if(word.length() > MAXSTROKEWORDLENGTH)
+            {
+                continue;
+            }
+            double score = double(size-1-i)/size;//列表反向显示，末尾为最常用
+            updateScore((pinyin.length()==word.length())?initialScores:otherScores,word,score);
+        }
+    }
+
+private:
+    QHash<QString,double> &initialScores;
+    QHash<QString,double> &otherScores;
+};
+
+StrokeIndex::StrokeIndex()
+{
+    resetStatistics();
+}
+/*
+ *@brief:   读笔画表，每行为"汉字 笔画序列"，笔画用数字1~5(横竖撇点折)或字母h、s、p、n(d)、z
+ * 表示，#开头的行为注释
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:笔画表文件路径
+ *@return:  文件是否打开成功
+ */
+bool StrokeIndex::loadStrokes(const QString &filePath)
+{
+    strokeTable.clear();
+    QFile strokeFile(filePath);
+    if(!strokeFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QRegExp lineRegExp("(\\S)\\s+([1-5hspndz]+)");
+    while(!strokeFile.atEnd())
+    {
+        QString lineText = QString::fromUtf8(strokeFile.readLine()).trimmed();
+        if(lineText.startsWith(QChar(0xFEFF)))//UTF-8 BOM
+        {
+            lineText.remove(0,1);
+        }
+        if(lineText.isEmpty() || lineText.startsWith('#') || !lineRegExp.exactMatch(lineText))
+        {
+            continue;
+        }
+        QByteArray strokes = lineRegExp.cap(2).toLatin1();
+        for(int i=0;i<strokes.size();i++)
+        {
+            switch(strokes.at(i))
+            {
+            case 'h': strokes[i] = '1'; break;
+            case 's': strokes[i] = '2'; break;
+            case 'p': strokes[i] = '3'; break;
+            case 'n':
+            case 'd': strokes[i] = '4'; break;
+            case 'z': strokes[i] = '5'; break;
+            default: break;
+            }
+        }
+        strokeTable.insert(lineRegExp.cap(1).at(0),strokes);
+    }
+    return true;
+}
+
+bool StrokeIndex::hasStrokes() const
+{
+    return !strokeTable.isEmpty();
+}
+/*
+ *@brief:   由拼音字典的字词构建索引。字词的笔画序列为各字笔画序列的连接；常用程度取字词在
+ * 各层拼音候选列表中的相对位置，优先用键长与字数相同的列表(单字为声母、词组为简拼)，字典在
+ * 这些列表中按常用程度排列。单字排在词组前面。构建后预先排好短前缀的前K个结果。
+ * 可以在后台线程调用，字典中不能有界面线程会修改的层
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   dictionary:分层字典(只读的层)
+ */
+void StrokeIndex::build(const LayeredDictionary &dictionary)
+{
+    clear();
+    QHash<QString,double> initialScores;//在简拼列表中的位置
+    QHash<QString,double> otherScores;//在其他列表中的位置
+    StrokeScoreVisitor visitor(initialScores,otherScores);
+    dictionary.visitEntries(visitor,false);//压缩字典逐块读取，不经过页面缓存
+    QHash<QString,double>::const_iterator it = otherScores.constBegin();
+    for(;it!=otherScores.constEnd();++it)
+    {
+        if(!initialScores.contains(it.key()))
+        {
+            initialScores.insert(it.key(),1.0+it.value());//只出现在全拼下的排在后面
+        }
+    }
+    //转换为笔画序列，有汉字不在笔画表中的字词不参与笔画输入
+    QVector<RankItem> rankItems;
+    for(it=initialScores.constBegin();it!=initialScores.constEnd();++it)
+    {
+        Entry entry;
+        entry.word = it.key();
+        for(int i=0;i<entry.word.length();i++)
+        {
+            QHash<QChar,QByteArray>::const_iterator strokeIt = strokeTable.constFind(entry.word.at(i));
+            if(strokeIt == strokeTable.constEnd())
+            {
+                entry.word.clear();
+                break;
+            }
+            entry.strokes.append(strokeIt.value());
+        }
+        if(entry.word.isEmpty())
+        {
+            continue;
+        }
+        RankItem rankItem = {entry.word.length(),it.value(),entries.size()};
+        rankItems.append(rankItem);
+        entries.append(entry);
+    }
+    std::sort(rankItems.begin(),rankItems.end(),lessRankItem);
+    for(int i=0;i<rankItems.size();i++)
+    {
+        entries[rankItems.at(i).index].rank = i;
+    }
+    std::sort(entries.begin(),entries.end(),lessEntry);
+    //预排序短前缀 1笔5个、2笔25个
+    for(int length=1;length<=PRECOMPUTEDSTROKES;length++)
+    {
+        int prefixCount = 1;
+        for(int i=0;i<length;i++)
+        {
+            prefixCount *= 5;
+        }
+        for(int n=0;n<prefixCount;n++)
+        {
+            QByteArray prefix(length,'1');
+            for(int i=length-1,value=n;i>=0;i--,value/=5)
+            {
+                prefix[i] = char('1'+value%5);
+            }
+            QVector<Entry>::const_iterator first = std::lower_bound(entries.constBegin(),entries.constEnd(),prefix,lessStrokes);
+            QVector<Entry>::const_iterator last = std::lower_bound(first,entries.constEnd(),prefix+'6',lessStrokes);
+            QVector<QPair<int,int> > rankList;//(排名,索引项)
+            rankList.reserve(int(last-first));
+            for(QVector<Entry>::const_iterator entryIt=first;entryIt!=last;++entryIt)
+            {
+                rankList.append(qMakePair(entryIt->rank,int(entryIt-entries.constBegin())));
+            }
+            int topCount = qMin(rankList.size(),PRECOMPUTEDTOPK);
+            std::partial_sort(rankList.begin(),rankList.begin()+topCount,rankList.end());
+            QVector<int> topList(topCount);
+            for(int i=0;i<topCount;i++)
+            {
+                topList[i] = rankList.at(i).second;
+            }
+            topLists.append(topList);
+        }
+    }
+}
+
+void StrokeIndex::clear()
+{
+    entries.clear();
+    topLists.clear();
+}
+
+bool StrokeIndex::isEmpty() const
+{
+    return entries.isEmpty();
+}
+
+int StrokeIndex::entryCount() const
+{
+    return entries.size();
+}
+/*
+ *@brief:   查找笔画前缀对应的字词。短前缀的结果个数不超过预排序的个数时直接取出；否则在有序
+ * 数组中二分定位前缀的范围，只对前maxResults个做部分排序。三笔以上的前缀范围已经很小
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   strokes:笔画序列，由'1'~'5'组成
+ *@param:   maxResults:最多返回的字词个数
+ *@return:  字词列表，常用的在前
+ */
+QStringList StrokeIndex::match(const QByteArray &strokes, int maxResults)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QStringList result;
+    int id = prefixId(strokes);
+    if(id >= 0 && id < topLists.size()
+            && (maxResults <= topLists.at(id).size() || topLists.at(id).size() < PRECOMPUTEDTOPK))
+    {
+        const QVector<int> &topList = topLists.at(id);
+        for(int i=0;i<topList.size() && i<maxResults;i++)
+        {
+            result.append(entries.at(topList.at(i)).word);
+        }
+        stats.precomputedCount++;
+    }
+    else if(!strokes.isEmpty())
+    {
+        QVector<Entry>::const_iterator first = std::lower_bound(entries.constBegin(),entries.constEnd(),strokes,lessStrokes);
+        QVector<Entry>::const_iterator last = std::lower_bound(first,entries.constEnd(),strokes+'6',lessStrokes);
+        QVector<QPair<int,int> > rankList;//(排名,索引项)
+        rankList.reserve(int(last-first));
+        for(QVector<Entry>::const_iterator entryIt=first;entryIt!=last;++entryIt)
+        {
+            rankList.append(qMakePair(entryIt->rank,int(entryIt-entries.constBegin())));
+        }
+        int topCount = qMin(rankList.size(),maxResults);
+        std::partial_sort(rankList.begin(),rankList.begin()+topCount,rankList.end());
+        for(int i=0;i<topCount;i++)
+        {
+            result.append(entries.at(rankList.at(i).second).word);
+        }
+        stats.scannedEntries += rankList.size();
+    }
+    stats.latency.add(timer.nsecsElapsed());
+    return result;
+}
+
+StrokeIndex::Statistics StrokeIndex::statistics() const
+{
+    return stats;
+}
+
+void StrokeIndex::resetStatistics()
+{
+    stats.precomputedCount = 0;
+    stats.scannedEntries = 0;
+    stats.latency.clear();
+}
+/*
+ *@brief:   笔画序列转换为笔画字符，用于在候选字母框中显示已输入的笔画
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   strokes:笔画序列，由'1'~'5'组成
+ */
+QString StrokeIndex::toGlyphs(const QByteArray &strokes)
+{
+    QString glyphs = QString::fromUtf8(STROKE_GLYPHS);
+    QString text;
+    for(int i=0;i<strokes.size();i++)
+    {
+        int stroke = strokes.at(i)-'1';
+        if(stroke >= 0 && stroke < glyphs.length())
+        {
+            text.append(glyphs.at(stroke));
+        }
+    }
+    return text;
+}
+
+bool StrokeIndex::lessEntry(const Entry &left, const Entry &right)
+{
+    if(left.strokes != right.strokes)
+    {
+        return left.strokes < right.strokes;
+    }
+    return left.rank < right.rank;
+}
+
+bool StrokeIndex::lessStrokes(const Entry &entry, const QByteArray &strokes)
+{
+    return entry.strokes < strokes;
+}
+
+int StrokeIndex::prefixId(const QByteArray &strokes)
+{
+    if(strokes.isEmpty() || strokes.size() > PRECOMPUTEDSTROKES)
+    {
+        return -1;
+    }
+    int id = 0;
+    int levelStart = 0;//笔画数更少的前缀个数之和，1笔为0，2笔为5
+    int levelCount = 1;
+    for(int i=0;i<strokes.size();i++)
+    {
+        int stroke = strokes.at(i)-'1';
+        if(stroke < 0 || stroke > 4)
+        {
+            return -1;
+        }
+        if(i > 0)
+        {
+            levelStart += levelCount;
+        }
+        levelCount *= 5;
+        id = id*5+stroke;
+    }
+    return levelStart+id;
+}
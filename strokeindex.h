@@ -0,0 +1,68 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  笔画索引，由笔画表(汉字的笔顺)将拼音字典中的字词转换为笔画序列(1横2竖3撇4点5折)
+ * 后排序，按笔画前缀查找字词并按常用程度排序。一两笔的前缀对应数千个字，这些短前缀的
+ * 前K个结果在构建时预先排好，查询时直接取出
+ */
+#ifndef STROKEINDEX_H
+#define STROKEINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include "latencyhistogram.h"
+#include "layereddictionary.h"
+
+class StrokeIndex
+{
+public:
+    //查询开销统计
+    struct Statistics
+    {
+        quint64 precomputedCount;//直接取预排序结果的次数
+        quint64 scannedEntries;//累计扫描的索引项数
+        LatencyHistogram latency;//每次查询的耗时分布
+    };
+
+    StrokeIndex();
+
+    bool loadStrokes(const QString &filePath);//读笔画表
+    bool hasStrokes() const;
+    void build(const LayeredDictionary &dictionary);//由拼音字典的字词构建索引
+    void clear();
+    bool isEmpty() const;
+    int entryCount() const;
+    QStringList match(const QByteArray &strokes,int maxResults);//笔画前缀对应的字词，常用的在前
+    Statistics statistics() const;
+    void resetStatistics();
+
+    static QString toGlyphs(const QByteArray &strokes);//笔画序列转换为笔画字符显示
+
+private:
+    //索引项 按笔画序列排序，笔画序列相同时按排名
+    struct Entry
+    {
+        QByteArray strokes;
+        QString word;
+        int rank;//常用程度排名，越小越常用
+    };
+    static bool lessEntry(const Entry &left,const Entry &right);
+    static bool lessStrokes(const Entry &entry,const QByteArray &strokes);
+    static int prefixId(const QByteArray &strokes);//短前缀在预排序列表中的序号
+
+    QHash<QChar,QByteArray> strokeTable;//汉字-笔画序列
+    QVector<Entry> entries;
+    QVector<QVector<int> > topLists;//短前缀的前K个索引项，按排名排列
+    Statistics stats;
+};
+
+#endif // STROKEINDEX_H
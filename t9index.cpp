@@ -0,0 +1,272 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  九宫格(T9)数字串索引，将拼音字典的键转换为数字串后排序，按数字串查找对应的拼音。
+ * 查找只需在有序数组中二分定位，不需要枚举数字串对应的所有字母组合
+ */
+#include "t9index.h"
+#include "pinyinsyllable.h"
+#include <QHash>
+#include <QPair>
+#include <QElapsedTimer>
+#include <algorithm>
+
+#define PRECOMPUTEDDIGITS   2   //预排序结果的最大数字串长度
+#define PRECOMPUTEDTOPK     32  //每个短数字串预排序的拼音个数
+
+//数字键2~9对应的字母
+static const char *const KEY_LETTERS[] = {"","","abc","def","ghi","jkl","mno","pqrs","tuv","wxyz"};
+
+T9Index::T9Index()
+{
+    resetStatistics();
+}
+/*
+ *@brief:   由拼音字典的键构建索引。每个键转换为数字串，并给出排名：由合法音节组成的全拼排在
+ * 简拼前面，音节数少的排在前面
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   keyList:拼音字典的所有键
+ */
+void T9Index::build(const QList<QString> &keyList)
+{
+    entries.clear();
+    entries.reserve(keyList.size());
+    for(int i=0;i<keyList.size();i++)
+    {
+        Entry entry;
+        entry.pinyin = keyList.at(i);
+        entry.digits = toDigits(entry.pinyin);
+        if(entry.digits.length() != entry.pinyin.length())//含有非字母的键
+        {
+            continue;
+        }
+        QStringList syllableList = PinyinSyllable::split(entry.pinyin);
+        bool isFullPinyin = true;
+        for(int j=0;isFullPinyin && j<syllableList.size();j++)
+        {
+            isFullPinyin = PinyinSyllable::isSyllable(syllableList.at(j));
+        }
+        entry.rank = isFullPinyin?(100-syllableList.size()):(-entry.pinyin.length());
+        entries.append(entry);
+    }
+    std::sort(entries.begin(),entries.end(),lessEntry);
+    //预排序短数字串 1位8个、2位64个，每个对应数千个索引项，查询时直接取出
+    topLists.clear();
+    quint64 scannedEntries = 0;
+    for(int length=1;length<=PRECOMPUTEDDIGITS;length++)
+    {
+        int digitsCount = 1;
+        for(int i=0;i<length;i++)
+        {
+            digitsCount *= 8;
+        }
+        for(int n=0;n<digitsCount;n++)
+        {
+            QString digits(length,QChar('2'));
+            for(int i=length-1,value=n;i>=0;i--,value/=8)
+            {
+                digits[i] = QChar('2'+value%8);
+            }
+            topLists.append(scan(digits,PRECOMPUTEDTOPK,scannedEntries));
+        }
+    }
+}
+
+void T9Index::clear()
+{
+    entries.clear();
+    topLists.clear();
+}
+
+bool T9Index::isEmpty() const
+{
+    return entries.isEmpty();
+}
+/*
+ *@brief:   获取数字串对应的拼音。一两位的数字串直接取构建时预排序的结果，更长的数字串
+ * 对应的索引项少，查询时扫描
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   digits:数字串，只含2~9
+ *@param:   maxResults:最多返回的拼音个数
+ *@return:  拼音列表，按可能性由高到低
+ */
+QStringList T9Index::decode(const QString &digits, int maxResults)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QStringList result;
+    int id = prefixId(digits);
+    if(id >= 0 && id < topLists.size() && maxResults <= PRECOMPUTEDTOPK)
+    {
+        result = topLists.at(id).mid(0,maxResults);
+        stats.precomputedCount++;
+    }
+    else
+    {
+        result = scan(digits,maxResults,stats.scannedEntries);
+    }
+    stats.latency.add(timer.nsecsElapsed());
+    return result;
+}
+/*
+ *@brief:   扫描数字串对应的拼音。先二分定位到以该数字串开头的索引项范围：数字串完全相同的
+ * 拼音排在前面；其余为更长的拼音，取其与数字串等长的前缀(正在输入的拼音)，按共享该前缀的
+ * 拼音个数排序，常见的拼音前缀对应的键多
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   digits:数字串
+ *@param:   maxResults:最多返回的拼音个数
+ *@param:   scannedEntries:累加扫描的索引项数
+ */
+QStringList T9Index::scan(const QString &digits, int maxResults, quint64 &scannedEntries) const
+{
+    QStringList result;
+    QHash<QString,int> prefixCount;
+    QVector<Entry>::const_iterator it = std::lower_bound(entries.constBegin(),entries.constEnd(),digits,lessDigits);
+    for(;it!=entries.constEnd() && it->digits.startsWith(digits);++it)
+    {
+        scannedEntries++;
+        if(it->digits.length() == digits.length())//完全匹配，已按排名排序
+        {
+            if(result.size() < maxResults)
+            {
+                result.append(it->pinyin);
+            }
+        }
+        else
+        {
+            prefixCount[it->pinyin.left(digits.length())]++;
+        }
+    }
+    if(result.size() < maxResults && !prefixCount.isEmpty())
+    {
+        QList<QPair<int,QString> > prefixList;
+        QHash<QString,int>::const_iterator prefixIt = prefixCount.constBegin();
+        for(;prefixIt!=prefixCount.constEnd();++prefixIt)
+        {
+            if(!result.contains(prefixIt.key()))
+            {
+                prefixList.append(qMakePair(prefixIt.value(),prefixIt.key()));
+            }
+        }
+        std::sort(prefixList.begin(),prefixList.end(),lessPrefixCount);
+        for(int i=0;i<prefixList.size() && result.size()<maxResults;i++)
+        {
+            result.append(prefixList.at(i).second);
+        }
+    }
+    return result;
+}
+
+T9Index::Statistics T9Index::statistics() const
+{
+    return stats;
+}
+
+void T9Index::resetStatistics()
+{
+    stats.precomputedCount = 0;
+    stats.scannedEntries = 0;
+    stats.latency.clear();
+}
+/*
+ *@brief:   拼音转换为数字串，非小写字母的字符被忽略
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:拼音
+ */
+QString T9Index::toDigits(const QString &pinyin)
+{
+    QString digits;
+    digits.reserve(pinyin.length());
+    for(int i=0;i<pinyin.length();i++)
+    {
+        char letter = pinyin.at(i).toLatin1();
+        for(int digit=2;digit<=9;digit++)
+        {
+            if(letter>='a' && letter<='z' && qstrchr(KEY_LETTERS[digit],letter))
+            {
+                digits.append(QChar('0'+digit));
+                break;
+            }
+        }
+    }
+    return digits;
+}
+/*
+ *@brief:   数字键对应的字母，用于显示按键文本
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   digit:数字0~9
+ */
+QString T9Index::keyLetters(int digit)
+{
+    if(digit<0 || digit>9)
+    {
+        return QString();
+    }
+    return QString::fromLatin1(KEY_LETTERS[digit]);
+}
+
+bool T9Index::lessEntry(const Entry &left, const Entry &right)
+{
+    if(left.digits != right.digits)
+    {
+        return left.digits < right.digits;
+    }
+    if(left.rank != right.rank)
+    {
+        return left.rank > right.rank;
+    }
+    return left.pinyin < right.pinyin;
+}
+
+bool T9Index::lessDigits(const Entry &entry, const QString &digits)
+{
+    return entry.digits < digits;
+}
+
+/*
+ *@brief:   短数字串在预排序列表中的序号，1位的在前，2位的在后，不是短数字串时返回-1
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+int T9Index::prefixId(const QString &digits)
+{
+    if(digits.isEmpty() || digits.length() > PRECOMPUTEDDIGITS)
+    {
+        return -1;
+    }
+    int id = 0;
+    int offset = 0;
+    int levelCount = 1;
+    for(int i=0;i<digits.length();i++)
+    {
+        int digit = digits.at(i).unicode()-'2';
+        if(digit < 0 || digit > 7)
+        {
+            return -1;
+        }
+        id = id*8+digit;
+        offset += (i>0)?levelCount:0;
+        levelCount *= 8;
+    }
+    return offset+id;
+}
+
+bool T9Index::lessPrefixCount(const QPair<int, QString> &left, const QPair<int, QString> &right)
+{
+    if(left.first != right.first)
+    {
+        return left.first > right.first;
+    }
+    return left.second < right.second;
+}
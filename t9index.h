@@ -0,0 +1,65 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  九宫格(T9)数字串索引，将拼音字典的键转换为数字串后排序，按数字串查找对应的拼音。
+ * 查找只需在有序数组中二分定位，不需要枚举数字串对应的所有字母组合
+ */
+#ifndef T9INDEX_H
+#define T9INDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QPair>
+#include "latencyhistogram.h"
+
+class T9Index
+{
+public:
+    //查询开销统计
+    struct Statistics
+    {
+        quint64 precomputedCount;//直接取预排序结果的次数
+        quint64 scannedEntries;//累计扫描的索引项数
+        LatencyHistogram latency;//每次查询的耗时分布
+    };
+
+    T9Index();
+
+    void build(const QList<QString> &keyList);//由拼音字典的键构建索引
+    void clear();
+    bool isEmpty() const;
+    QStringList decode(const QString &digits,int maxResults);//数字串对应的拼音，按可能性由高到低
+    Statistics statistics() const;
+    void resetStatistics();
+
+    static QString toDigits(const QString &pinyin);//拼音转换为数字串
+    static QString keyLetters(int digit);//数字键对应的字母
+
+private:
+    //索引项 按数字串排序，数字串相同时按排名由高到低
+    struct Entry
+    {
+        QString digits;
+        QString pinyin;
+        int rank;
+    };
+    static bool lessEntry(const Entry &left,const Entry &right);
+    static bool lessDigits(const Entry &entry,const QString &digits);
+    static bool lessPrefixCount(const QPair<int,QString> &left,const QPair<int,QString> &right);
+    static int prefixId(const QString &digits);//短数字串在预排序列表中的序号
+    QStringList scan(const QString &digits,int maxResults,quint64 &scannedEntries) const;//扫描索引项
+
+    QVector<Entry> entries;
+    QVector<QStringList> topLists;//短数字串的前K个拼音
+    Statistics stats;
+};
+
+#endif // T9INDEX_H
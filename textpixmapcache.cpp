@@ -0,0 +1,160 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  文字图片缓存，将按键及候选词的文字按字体、颜色预先渲染为图片，重绘时直接贴图，
+ * 避免每次重绘都重新排版和光栅化中文字形。缓存按图片占用的内存限制大小，超出时淘汰最久
+ * 未使用的图片
+ */
+#include "textpixmapcache.h"
+#include <QPainter>
+#include <QFontMetrics>
+#include <QStylePainter>
+#include <QStyleOptionToolButton>
+
+#define DEFAULTCACHEBYTES   (1024*1024) //默认缓存大小(字节)
+
+TextPixmapCache::TextPixmapCache()
+{
+    pixmapCache.setMaxCost(DEFAULTCACHEBYTES);
+    resetStatistics();
+}
+/*
+ *@brief:   设置缓存大小，减小时立即淘汰最久未使用的图片
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   bytes:缓存大小(字节)，为0时不缓存
+ */
+void TextPixmapCache::setMaxBytes(int bytes)
+{
+    pixmapCache.setMaxCost(qMax(0,bytes));
+}
+/*
+ *@brief:   获取文字图片，缓存中不存在时按字体、颜色渲染到透明背景的图片上并放入缓存。
+ * 多行文字(如九宫格按键)居中对齐
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   text:文字
+ *@param:   font:字体
+ *@param:   color:文字颜色
+ */
+QPixmap TextPixmapCache::pixmap(const QString &text, const QFont &font, const QColor &color)
+{
+    QString key = cacheKey(text,font,color);
+    QPixmap *cachedPixmap = pixmapCache.object(key);
+    if(cachedPixmap)
+    {
+        stats.hitCount++;
+        return *cachedPixmap;
+    }
+    QFontMetrics fontMetrics(font);
+    QRect textRect = fontMetrics.boundingRect(QRect(0,0,4096,4096),Qt::AlignCenter,text);
+    QPixmap textPixmap(qMax(1,textRect.width()),qMax(1,textRect.height()));
+    textPixmap.fill(Qt::transparent);
+    QPainter painter(&textPixmap);
+    painter.setFont(font);
+    painter.setPen(color);
+    painter.drawText(textPixmap.rect(),Qt::AlignCenter,text);
+    painter.end();
+    stats.renderCount++;
+    pixmapCache.insert(key,new QPixmap(textPixmap),textPixmap.width()*textPixmap.height()*4);
+    return textPixmap;
+}
+/*
+ *@brief:   预先渲染一组文字，如当前皮肤的按键文字和最常用的候选字，
+ * 使第一次显示时也只需要贴图
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   textList:文字列表
+ *@param:   font:字体
+ *@param:   color:文字颜色
+ */
+void TextPixmapCache::warmUp(const QStringList &textList, const QFont &font, const QColor &color)
+{
+    for(int i=0;i<textList.size();i++)
+    {
+        if(!textList.at(i).trimmed().isEmpty() && !pixmapCache.contains(cacheKey(textList.at(i),font,color)))
+        {
+            pixmap(textList.at(i),font,color);
+        }
+    }
+}
+
+void TextPixmapCache::clear()
+{
+    pixmapCache.clear();
+}
+
+TextPixmapCache::Statistics TextPixmapCache::statistics() const
+{
+    Statistics snapshot = stats;
+    snapshot.pixmapCount = pixmapCache.count();
+    snapshot.totalBytes = pixmapCache.totalCost();
+    snapshot.maxBytes = pixmapCache.maxCost();
+    return snapshot;
+}
+
+void TextPixmapCache::resetStatistics()
+{
+    stats.hitCount = 0;
+    stats.renderCount = 0;
+    stats.pixmapCount = 0;
+    stats.totalBytes = 0;
+    stats.maxBytes = 0;
+}
+
+QString TextPixmapCache::cacheKey(const QString &text, const QFont &font, const QColor &color)
+{
+    return text+QChar(0)+font.key()+QChar(0)+QString::number(color.rgba(),16);
+}
+
+/*
+ *@brief:   使用文字图片缓存绘制文字的按键构造函数
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   cache:文字图片缓存，由键盘持有，多个按键共用
+ *@param:   parent:父对象
+ */
+CachedTextButton::CachedTextButton(TextPixmapCache *cache, QWidget *parent) :
+    QToolButton(parent),textCache(cache)
+{
+}
+/*
+ *@brief:   绘制按键。先用样式绘制不带文字的按键背景，再将缓存的文字图片贴到按键中央。
+ * 按键文字中的&&是为了避免被当作快捷键标志，绘制时还原为&
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void CachedTextButton::paintEvent(QPaintEvent *event)
+{
+    if(!textCache)
+    {
+        QToolButton::paintEvent(event);
+        return;
+    }
+    QStylePainter painter(this);
+    QStyleOptionToolButton option;
+    initStyleOption(&option);
+    QString labelText = option.text;
+    option.text.clear();
+    painter.drawComplexControl(QStyle::CC_ToolButton,option);
+    labelText.replace("&&","&");
+    if(labelText.trimmed().isEmpty())
+    {
+        return;
+    }
+    QPalette::ColorGroup colorGroup = isEnabled()?QPalette::Active:QPalette::Disabled;
+    QPixmap textPixmap = textCache->pixmap(labelText,font(),palette().color(colorGroup,QPalette::ButtonText));
+    QPoint topLeft = rect().center()-QPoint(textPixmap.width()/2,textPixmap.height()/2);
+    if(isDown())//按下时与样式绘制的文字一样稍作偏移
+    {
+        topLeft += QPoint(style()->pixelMetric(QStyle::PM_ButtonShiftHorizontal,&option,this),
+                          style()->pixelMetric(QStyle::PM_ButtonShiftVertical,&option,this));
+    }
+    painter.drawPixmap(topLeft,textPixmap);
+}
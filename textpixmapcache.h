@@ -0,0 +1,68 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  文字图片缓存，将按键及候选词的文字按字体、颜色预先渲染为图片，重绘时直接贴图，
+ * 避免每次重绘都重新排版和光栅化中文字形。缓存按图片占用的内存限制大小，超出时淘汰最久
+ * 未使用的图片
+ */
+#ifndef TEXTPIXMAPCACHE_H
+#define TEXTPIXMAPCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QFont>
+#include <QColor>
+#include <QPixmap>
+#include <QCache>
+#include <QToolButton>
+
+class TextPixmapCache
+{
+public:
+    //缓存统计
+    struct Statistics
+    {
+        quint64 hitCount;//命中次数
+        quint64 renderCount;//渲染次数
+        int pixmapCount;//缓存的图片个数
+        int totalBytes;//缓存的图片占用的内存(字节)
+        int maxBytes;//缓存大小上限(字节)
+    };
+
+    TextPixmapCache();
+
+    void setMaxBytes(int bytes);//设置缓存大小
+    QPixmap pixmap(const QString &text,const QFont &font,const QColor &color);//获取文字图片，不存在时渲染
+    void warmUp(const QStringList &textList,const QFont &font,const QColor &color);//预先渲染
+    void clear();
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    static QString cacheKey(const QString &text,const QFont &font,const QColor &color);
+
+    QCache<QString,QPixmap> pixmapCache;//键为文字+字体+颜色，代价为图片字节数
+    Statistics stats;
+};
+
+/*使用文字图片缓存绘制文字的按键，按键背景仍由样式绘制*/
+class CachedTextButton : public QToolButton
+{
+    Q_OBJECT
+public:
+    explicit CachedTextButton(TextPixmapCache *cache,QWidget *parent = 0);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+
+private:
+    TextPixmapCache *textCache;
+};
+
+#endif // TEXTPIXMAPCACHE_H
@@ -0,0 +1,402 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  触摸按键输入，直接处理按键区域的触摸事件。每个触摸点独立跟踪按下的按键，
+ * 多指交替输入时按按下的顺序提交(按键翻转)，不会因为鼠标模拟只有一个指针而丢键；
+ * 支持按下即提交、按键预览及事件到提交的耗时统计
+ */
+#include "touchkeyinput.h"
+#include <QTouchEvent>
+
+#define PREVIEWSCALE    2       //预览文字相对按键文字的放大倍数
+#define PREVIEWSPACING  4       //预览与按键的间距(像素)
+
+/*
+ *@brief:   触摸按键输入构造函数
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   previewParent:按键预览的父部件，需为所有按键的祖先部件(一般为键盘窗口)
+ *@param:   parent:父对象
+ */
+TouchKeyInput::TouchKeyInput(QWidget *previewParent, QObject *parent) :
+    QObject(parent),isPressCommit(false),isPreviewEnabled(true),previewWidget(previewParent),previewLabel(NULL)
+{
+    autoRepeatTimer = new QTimer(this);
+    autoRepeatTimer->setSingleShot(true);
+    connect(autoRepeatTimer,SIGNAL(timeout()),this,SLOT(autoRepeatSlot()));
+    resetStatistics();
+}
+/*
+ *@brief:   处理按键区域的触摸事件。区域内的按键不接收触摸事件，触摸事件传递到区域，
+ * 由区域按触摸点位置找到对应的按键；接受触摸事件后系统不再为该次触摸模拟鼠标事件
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   keyArea:按键区域
+ */
+void TouchKeyInput::addKeyArea(QWidget *keyArea)
+{
+    keyArea->setAttribute(Qt::WA_AcceptTouchEvents);
+    keyArea->installEventFilter(this);
+}
+/*
+ *@brief:   设置按下即提交。默认松开时提交，按下即提交可以减少一次触摸的延时，
+ * 但按错键时无法通过滑出按键取消
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   enabled:按下即提交使能
+ */
+void TouchKeyInput::setPressCommitEnabled(bool enabled)
+{
+    isPressCommit = enabled;
+}
+
+bool TouchKeyInput::isPressCommitEnabled() const
+{
+    return isPressCommit;
+}
+/*
+ *@brief:   设置按键预览，手指遮挡按键时在按键上方显示放大的按键文字
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   enabled:按键预览使能
+ */
+void TouchKeyInput::setPreviewEnabled(bool enabled)
+{
+    isPreviewEnabled = enabled;
+    if(!enabled)
+    {
+        hidePreview();
+    }
+}
+
+TouchKeyInput::Statistics TouchKeyInput::statistics() const
+{
+    return stats;
+}
+
+void TouchKeyInput::resetStatistics()
+{
+    stats.touchPointCount = 0;
+    stats.commitCount = 0;
+    stats.rolloverCount = 0;
+    stats.cancelCount = 0;
+    stats.commitLatency.clear();
+}
+/*
+ *@brief:   按键区域的触摸事件处理。同一事件中先处理松开的触摸点，再处理按下的触摸点，
+ * 保证先按下的按键先提交
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+bool TouchKeyInput::eventFilter(QObject *watched, QEvent *event)
+{
+    switch(event->type())
+    {
+    case QEvent::TouchBegin:
+    case QEvent::TouchUpdate:
+    case QEvent::TouchEnd:
+    {
+        QElapsedTimer eventTimer;
+        eventTimer.start();
+        QWidget *keyArea = qobject_cast<QWidget *>(watched);
+        QList<QTouchEvent::TouchPoint> touchPoints = static_cast<QTouchEvent *>(event)->touchPoints();
+        for(int i=0;i<touchPoints.size();i++)
+        {
+            int id = touchPoints.at(i).id();
+            if(touchPoints.at(i).state() == Qt::TouchPointReleased)
+            {
+                releaseKey(id,isInsideKey(id,keyArea,touchPoints.at(i).pos()),eventTimer);
+            }
+            else if(touchPoints.at(i).state() == Qt::TouchPointMoved)
+            {
+                moveKey(id,isInsideKey(id,keyArea,touchPoints.at(i).pos()));
+            }
+        }
+        for(int i=0;i<touchPoints.size();i++)
+        {
+            if(touchPoints.at(i).state() == Qt::TouchPointPressed && keyArea)
+            {
+                QToolButton *button = qobject_cast<QToolButton *>(keyArea->childAt(touchPoints.at(i).pos().toPoint()));
+                if(button && button->isEnabled())
+                {
+                    pressKey(touchPoints.at(i).id(),button,eventTimer);
+                }
+            }
+        }
+        event->accept();
+        return true;
+    }
+#if QT_VERSION >= 0x050000
+    case QEvent::TouchCancel:
+        cancelAll();
+        event->accept();
+        return true;
+#endif
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched,event);
+}
+/*
+ *@brief:   长按自动重复，与按键自身的自动重复设置(延时、间隔)一致
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void TouchKeyInput::autoRepeatSlot()
+{
+    if(!repeatButton)
+    {
+        return;
+    }
+    repeatButton->click();
+    if(repeatButton)
+    {
+        repeatButton->setDown(true);
+        stats.commitCount++;
+        autoRepeatTimer->start(repeatButton->autoRepeatInterval());
+    }
+}
+/*
+ *@brief:   触摸点按下按键。松开时提交的模式下，之前按下还未提交的按键按顺序先提交，
+ * 即后一个按键按下时前一个按键视为完成，手指交替输入时不会打乱顺序；
+ * 自动重复的按键(如删除)总是按下即提交
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   id:触摸点标识
+ *@param:   button:按下的按键
+ *@param:   eventTimer:事件到达时开始的计时
+ */
+void TouchKeyInput::pressKey(int id, QToolButton *button, const QElapsedTimer &eventTimer)
+{
+    stats.touchPointCount++;
+    for(int i=0;i<touchKeys.size();i++)
+    {
+        if(!touchKeys.at(i).isCommitted)
+        {
+            commitKey(touchKeys[i],eventTimer);
+            stats.rolloverCount++;
+        }
+    }
+    TouchKey touchKey;
+    touchKey.id = id;
+    touchKey.button = button;
+    touchKey.isCommitted = false;
+    touchKeys.append(touchKey);
+    QPointer<QToolButton> guard(button);
+    if(isPressCommit || button->autoRepeat())
+    {
+        commitKey(touchKeys.last(),eventTimer);
+    }
+    if(!guard)//提交时按键被删除
+    {
+        return;
+    }
+    button->setDown(true);
+    showPreview(button);
+    if(button->autoRepeat())
+    {
+        repeatButton = button;
+        autoRepeatTimer->start(button->autoRepeatDelay());
+    }
+}
+/*
+ *@brief:   触摸点移动，还未提交的按键随触摸点是否在按键内显示按下或弹起状态，
+ * 提示滑出按键后松开将取消该按键
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   id:触摸点标识
+ *@param:   isInside:触摸点是否在按下的按键内
+ */
+void TouchKeyInput::moveKey(int id, bool isInside)
+{
+    for(int i=0;i<touchKeys.size();i++)
+    {
+        const TouchKey &touchKey = touchKeys.at(i);
+        if(touchKey.id!=id || touchKey.isCommitted || !touchKey.button)
+        {
+            continue;
+        }
+        if(touchKey.button->isDown() != isInside)
+        {
+            touchKey.button->setDown(isInside);
+            if(isInside)
+            {
+                showPreview(touchKey.button);
+            }
+            else if(touchKey.button == previewButton)
+            {
+                hidePreview();
+            }
+        }
+        return;
+    }
+}
+/*
+ *@brief:   触摸点松开，在按键内松开时提交还未提交的按键，滑出按键后松开则取消，然后恢复按键状态
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   id:触摸点标识
+ *@param:   isInside:松开的位置是否在按下的按键内
+ *@param:   eventTimer:事件到达时开始的计时
+ */
+void TouchKeyInput::releaseKey(int id, bool isInside, const QElapsedTimer &eventTimer)
+{
+    for(int i=0;i<touchKeys.size();i++)
+    {
+        if(touchKeys.at(i).id != id)
+        {
+            continue;
+        }
+        TouchKey touchKey = touchKeys.takeAt(i);
+        if(!touchKey.isCommitted)
+        {
+            if(isInside)
+            {
+                commitKey(touchKey,eventTimer);
+            }
+            else
+            {
+                stats.cancelCount++;
+            }
+        }
+        if(touchKey.button)
+        {
+            touchKey.button->setDown(false);
+            if(touchKey.button == repeatButton)
+            {
+                autoRepeatTimer->stop();
+                repeatButton = NULL;
+            }
+            if(touchKey.button == previewButton)
+            {
+                hidePreview();
+            }
+        }
+        return;
+    }
+}
+/*
+ *@brief:   判断触摸点是否在其按下的按键内
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   id:触摸点标识
+ *@param:   keyArea:触摸事件所在的按键区域
+ *@param:   pos:触摸点在按键区域中的位置
+ */
+bool TouchKeyInput::isInsideKey(int id, QWidget *keyArea, const QPointF &pos) const
+{
+    for(int i=0;i<touchKeys.size();i++)
+    {
+        if(touchKeys.at(i).id == id)
+        {
+            QToolButton *button = touchKeys.at(i).button;
+            if(!button || !keyArea)
+            {
+                return false;
+            }
+            return button->rect().contains(button->mapFrom(keyArea,pos.toPoint()));
+        }
+    }
+    return false;
+}
+/*
+ *@brief:   提交按键，发出按键的clicked信号，与鼠标点击走相同的处理流程。
+ * 提交后按键仍处于按下状态，直到触摸点松开
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   touchKey:触摸点按下的按键
+ *@param:   eventTimer:事件到达时开始的计时
+ */
+void TouchKeyInput::commitKey(TouchKey &touchKey, const QElapsedTimer &eventTimer)
+{
+    touchKey.isCommitted = true;
+    if(!touchKey.button)
+    {
+        return;
+    }
+    touchKey.button->click();
+    if(touchKey.button)
+    {
+        touchKey.button->setDown(true);
+    }
+    stats.commitCount++;
+    stats.commitLatency.add(eventTimer.nsecsElapsed());
+}
+/*
+ *@brief:   触摸被系统取消(如弹出系统手势)，恢复所有按键状态，未提交的按键不再提交
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void TouchKeyInput::cancelAll()
+{
+    for(int i=0;i<touchKeys.size();i++)
+    {
+        if(touchKeys.at(i).button)
+        {
+            touchKeys.at(i).button->setDown(false);
+        }
+        stats.cancelCount++;
+    }
+    touchKeys.clear();
+    autoRepeatTimer->stop();
+    repeatButton = NULL;
+    hidePreview();
+}
+/*
+ *@brief:   在按键上方显示放大的按键文字，只预览单个字符的按键，功能键及多行文字的按键
+ * 只显示按下状态。预览的颜色取自按键当前皮肤的颜色
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   button:按下的按键
+ */
+void TouchKeyInput::showPreview(QToolButton *button)
+{
+    QString text = button->text().replace("&&","&");
+    if(!isPreviewEnabled || !previewWidget || text.trimmed().isEmpty() || text.length()>2 || text.contains('\n'))
+    {
+        hidePreview();
+        return;
+    }
+    if(!previewLabel)
+    {
+        previewLabel = new QLabel(previewWidget);
+        previewLabel->setAlignment(Qt::AlignCenter);
+        previewLabel->setAttribute(Qt::WA_TransparentForMouseEvents);
+    }
+    previewLabel->setStyleSheet(QString("QLabel{background-color:%1;color:%2;border-radius:6px;}")
+                                .arg(button->palette().color(QPalette::Button).name())
+                                .arg(button->palette().color(QPalette::ButtonText).name()));
+    QFont previewFont = button->font();
+    if(previewFont.pixelSize() > 0)
+    {
+        previewFont.setPixelSize(previewFont.pixelSize()*PREVIEWSCALE);
+    }
+    else
+    {
+        previewFont.setPointSizeF(previewFont.pointSizeF()*PREVIEWSCALE);
+    }
+    previewLabel->setFont(previewFont);
+    previewLabel->setText(text);
+    QPoint buttonPos = button->mapTo(previewWidget,QPoint(0,0));
+    int previewHeight = button->height();
+    previewLabel->setGeometry(buttonPos.x(),qMax(0,buttonPos.y()-previewHeight-PREVIEWSPACING),
+                              button->width(),previewHeight);
+    previewLabel->raise();
+    previewLabel->show();
+    previewButton = button;
+}
+
+void TouchKeyInput::hidePreview()
+{
+    if(previewLabel)
+    {
+        previewLabel->hide();
+    }
+    previewButton = NULL;
+}
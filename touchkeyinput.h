@@ -0,0 +1,85 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  触摸按键输入，直接处理按键区域的触摸事件。每个触摸点独立跟踪按下的按键，
+ * 多指交替输入时按按下的顺序提交(按键翻转)，不会因为鼠标模拟只有一个指针而丢键；
+ * 支持按下即提交、按键预览及事件到提交的耗时统计
+ */
+#ifndef TOUCHKEYINPUT_H
+#define TOUCHKEYINPUT_H
+
+#include <QObject>
+#include <QWidget>
+#include <QToolButton>
+#include <QLabel>
+#include <QTimer>
+#include <QList>
+#include <QPointer>
+#include <QElapsedTimer>
+#include "latencyhistogram.h"
+
+class TouchKeyInput : public QObject
+{
+    Q_OBJECT
+public:
+    //触摸输入统计
+    struct Statistics
+    {
+        quint64 touchPointCount;//按下的触摸点数
+        quint64 commitCount;//提交的按键数(含自动重复)
+        quint64 rolloverCount;//因后续按键按下而提前提交的按键数
+        quint64 cancelCount;//被取消的触摸点数(含滑出按键后松开的)
+        LatencyHistogram commitLatency;//事件到达至按键提交完成的耗时分布(不含自动重复)
+    };
+
+    explicit TouchKeyInput(QWidget *previewParent,QObject *parent = 0);
+
+    void addKeyArea(QWidget *keyArea);//处理按键区域的触摸事件
+    void setPressCommitEnabled(bool enabled);//设置按下即提交
+    bool isPressCommitEnabled() const;
+    void setPreviewEnabled(bool enabled);//设置按键预览
+    Statistics statistics() const;
+    void resetStatistics();
+
+protected:
+    bool eventFilter(QObject *watched,QEvent *event);
+
+private slots:
+    void autoRepeatSlot();//长按自动重复
+
+private:
+    //触摸点按下的按键，按按下的顺序排列
+    struct TouchKey
+    {
+        int id;
+        QPointer<QToolButton> button;
+        bool isCommitted;
+    };
+
+    void pressKey(int id,QToolButton *button,const QElapsedTimer &eventTimer);
+    void moveKey(int id,bool isInside);
+    void releaseKey(int id,bool isInside,const QElapsedTimer &eventTimer);
+    bool isInsideKey(int id,QWidget *keyArea,const QPointF &pos) const;
+    void commitKey(TouchKey &touchKey,const QElapsedTimer &eventTimer);
+    void cancelAll();
+    void showPreview(QToolButton *button);
+    void hidePreview();
+
+    bool isPressCommit;
+    bool isPreviewEnabled;
+    QList<TouchKey> touchKeys;
+    QWidget *previewWidget;//预览标签的父部件，一般为键盘窗口
+    QLabel *previewLabel;//按键预览，显示在按键上方
+    QPointer<QToolButton> previewButton;
+    QPointer<QToolButton> repeatButton;//正在自动重复的按键
+    QTimer *autoRepeatTimer;
+    Statistics stats;
+};
+
+#endif // TOUCHKEYINPUT_H
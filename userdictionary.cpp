@@ -0,0 +1,478 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  用户词典，记录用户选择的候选词权重及组词学习到的新词组。
+ * 持久化采用追加写日志+定期压缩为二进制索引的方式，日志写入在独立线程批量进行，
+ * 避免频繁写慢速flash阻塞界面。
+ */
+#include "userdictionary.h"
+#include <QFile>
+#include <QDataStream>
+#include <QDebug>
+#include <algorithm>
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+#define USERDICTMAGIC       0x55534454  //二进制索引文件标识"USDT"
+#define USERDICTVERSION     1           //二进制索引文件版本
+#define FLUSHINTERVAL       3000        //批量写日志的间隔(ms)
+#define COMPACTTHRESHOLD    200         //日志记录数达到该值时压缩为二进制索引
+#define MAXWORDWEIGHT       10000       //候选词权重上限
+
+/*
+ *@brief:   将文件内容同步到存储设备，保证掉电时已返回的写操作不丢失
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   file:已打开的文件
+ */
+static void syncFile(QFile &file)
+{
+    file.flush();
+#ifdef Q_OS_UNIX
+    ::fsync(file.handle());
+#endif
+}
+
+UserDictionaryWriter::UserDictionaryWriter(const QString &logPath, const QString &indexPath)
+    :logFilePath(logPath),indexFilePath(indexPath)
+{
+}
+/*
+ *@brief:   追加日志记录，每批记录只打开并同步一次文件
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   records:编码后的记录，每行一条
+ */
+void UserDictionaryWriter::appendRecords(const QByteArray &records)
+{
+    if(records.isEmpty())
+    {
+        return;
+    }
+    QFile logFile(logFilePath);
+    if(!logFile.open(QIODevice::WriteOnly|QIODevice::Append))
+    {
+        qDebug()<<"UserDictionaryWriter:Failed to open"<<logFilePath;
+        return;
+    }
+    logFile.write(records);
+    syncFile(logFile);
+    logFile.close();
+}
+/*
+ *@brief:   写入压缩后的二进制索引并清空日志。先完整写入临时文件再重命名替换，任何时刻掉电
+ * 都至少保留一份完整的索引；日志记录带有序号，索引替换后日志清空前掉电，重放时会跳过已包含
+ * 在索引中的记录。
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   snapshot:序列化后的词典内容
+ */
+void UserDictionaryWriter::compact(const QByteArray &snapshot)
+{
+    QString tempFilePath = indexFilePath+".tmp";
+    QFile tempFile(tempFilePath);
+    if(!tempFile.open(QIODevice::WriteOnly|QIODevice::Truncate))
+    {
+        qDebug()<<"UserDictionaryWriter:Failed to open"<<tempFilePath;
+        return;
+    }
+    tempFile.write(snapshot);
+    syncFile(tempFile);
+    tempFile.close();
+    QFile::remove(indexFilePath);
+    if(!QFile::rename(tempFilePath,indexFilePath))
+    {
+        qDebug()<<"UserDictionaryWriter:Failed to rename"<<tempFilePath;
+        return;//保留日志，下次启动可从临时文件和日志恢复
+    }
+    QFile logFile(logFilePath);
+    if(logFile.open(QIODevice::WriteOnly|QIODevice::Truncate))
+    {
+        syncFile(logFile);
+        logFile.close();
+    }
+}
+
+/*
+ *@brief:   用户词典构造函数，加载二进制索引并重放日志，然后启动写线程
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   filePath:用户词典文件路径(不含后缀)，日志为.log，索引为.dat
+ *@param:   parent:父对象
+ */
+UserDictionary::UserDictionary(const QString &filePath, QObject *parent) :
+    QObject(parent),sequence(0),indexSequence(0),recordsSinceCompact(0)
+{
+    logFilePath = filePath+".log";
+    indexFilePath = filePath+".dat";
+    loadIndex();
+    replayLog();
+
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(FLUSHINTERVAL);
+    connect(&flushTimer,SIGNAL(timeout()),this,SLOT(flushSlot()));
+
+    writer = new UserDictionaryWriter(logFilePath,indexFilePath);
+    writer->moveToThread(&writerThread);
+    connect(this,SIGNAL(recordsReady(QByteArray)),writer,SLOT(appendRecords(QByteArray)));
+    connect(this,SIGNAL(compactRequested(QByteArray)),writer,SLOT(compact(QByteArray)));
+    writerThread.start(QThread::LowPriority);
+}
+
+UserDictionary::~UserDictionary()
+{
+    flush();
+    //阻塞调用一次，确保之前排队的写请求全部完成
+    QMetaObject::invokeMethod(writer,"appendRecords",Qt::BlockingQueuedConnection,
+                              Q_ARG(QByteArray,QByteArray()));
+    writerThread.quit();
+    writerThread.wait();
+    delete writer;
+}
+/*
+ *@brief:   提高拼音下候选词的权重，用户每选择一次候选词调用一次
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:输入的拼音
+ *@param:   word:选择的候选词
+ */
+void UserDictionary::learnWord(const QString &pinyin, const QString &word)
+{
+    if(pinyin.isEmpty() || word.isEmpty())
+    {
+        return;
+    }
+    applyRecord('W',pinyin,word,1);
+    appendRecord('W',pinyin,word,1);
+}
+/*
+ *@brief:   学习新词组，由多次连续选择的候选词组合而成
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   phrase:词组拼音，用'分隔，如ai'qing
+ *@param:   word:词组汉字
+ *@return:  是否为新学习的词组
+ */
+bool UserDictionary::learnPhrase(const QString &phrase, const QString &word)
+{
+    if(phrase.isEmpty() || word.isEmpty() || phraseSet.contains(phrase+"\t"+word))
+    {
+        return false;
+    }
+    applyRecord('P',phrase,word,0);
+    appendRecord('P',phrase,word,0);
+    return true;
+}
+/*
+ *@brief:   获取拼音下候选词的权重
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:输入的拼音
+ *@param:   word:候选词
+ */
+int UserDictionary::weight(const QString &pinyin, const QString &word) const
+{
+    return wordWeight.value(pinyin).value(word,0);
+}
+/*
+ *@brief:   获取拼音匹配的已学习词组
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:输入的拼音，支持全拼与简拼
+ */
+QStringList UserDictionary::phrases(const QString &pinyin) const
+{
+    return phraseIndex.values(pinyin);
+}
+/*
+ *@brief:   作为分层字典的一层，获取拼音匹配的词组。与拼音字典的顺序一致，优先显示的词在列表
+ * 后面，即最近学习的词组在后
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:输入的拼音
+ */
+QList<QString> UserDictionary::values(const QString &pinyin) const
+{
+    QList<QString> valueList;
+    QStringList learnedList = phraseIndex.values(pinyin);
+    for(int i=learnedList.size()-1;i>=0;i--)
+    {
+        valueList.append(learnedList.at(i));
+    }
+    return valueList;
+}
+/*
+ *@brief:   已学习词组的所有拼音(不重复)
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+QList<QString> UserDictionary::keys() const
+{
+    return phraseIndex.uniqueKeys();
+}
+/*
+ *@brief:   获取所有已学习的词组
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@return:  词组列表，每项为(拼音,汉字)
+ */
+QList<QPair<QString, QString> > UserDictionary::learnedPhrases() const
+{
+    return phraseList;
+}
+
+static bool lessWeight(const QPair<int,QString> &left,const QPair<int,QString> &right)
+{
+    return left.first < right.first;
+}
+/*
+ *@brief:   按权重调整候选词顺序。候选词列表是从末尾反向显示的，所以权重高的词稳定地移到
+ * 列表末尾，权重相同的词保持字典中原有的顺序
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   pinyin:输入的拼音
+ *@param:   candidates:候选词列表
+ */
+void UserDictionary::sortByWeight(const QString &pinyin, QList<QString> &candidates) const
+{
+    QHash<QString,QHash<QString,int> >::const_iterator it = wordWeight.constFind(pinyin);
+    if(it == wordWeight.constEnd() || candidates.size() < 2)
+    {
+        return;//该拼音没有学习记录，保持原顺序
+    }
+    QList<QPair<int,QString> > weightedList;
+    for(int i=0;i<candidates.size();i++)
+    {
+        weightedList.append(qMakePair(it.value().value(candidates.at(i),0),candidates.at(i)));
+    }
+    std::stable_sort(weightedList.begin(),weightedList.end(),lessWeight);
+    for(int i=0;i<weightedList.size();i++)
+    {
+        candidates[i] = weightedList.at(i).second;
+    }
+}
+/*
+ *@brief:   立即将缓存的记录交给写线程，不等待批量写入定时器
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void UserDictionary::flush()
+{
+    flushTimer.stop();
+    flushSlot();
+}
+/*
+ *@brief:   计算词组的匹配拼音，规则与拼音字典拆分词组一致：首字母简拼、第一个字全拼+其余
+ * 首字母、前两个字全拼+其余首字母......直到全拼
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   phrase:词组拼音，用'分隔
+ *@return:  去重后的匹配拼音列表
+ */
+QStringList UserDictionary::phraseKeys(const QString &phrase)
+{
+    QStringList partList;
+    QStringList splitList = phrase.split("'");
+    for(int i=0;i<splitList.size();i++)
+    {
+        if(!splitList.at(i).isEmpty())
+        {
+            partList.append(splitList.at(i));
+        }
+    }
+    QStringList keyList;
+    for(int fullCount=0;fullCount<=partList.size();fullCount++)
+    {
+        QString key;
+        for(int i=0;i<partList.size();i++)
+        {
+            key.append(i<fullCount?partList.at(i):partList.at(i).left(1));
+        }
+        if(!key.isEmpty() && !keyList.contains(key))
+        {
+            keyList.append(key);
+        }
+    }
+    return keyList;
+}
+/*
+ *@brief:   批量写入定时器响应槽，将缓存的记录交给写线程，记录数达到阈值时请求压缩
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void UserDictionary::flushSlot()
+{
+    if(!pendingRecords.isEmpty())
+    {
+        emit recordsReady(pendingRecords);
+        pendingRecords.clear();
+    }
+    if(recordsSinceCompact >= COMPACTTHRESHOLD)
+    {
+        indexSequence = sequence;
+        recordsSinceCompact = 0;
+        emit compactRequested(snapshot());
+    }
+}
+/*
+ *@brief:   加载二进制索引。索引替换过程中掉电可能只剩下临时文件，此时从临时文件加载
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void UserDictionary::loadIndex()
+{
+    QFile indexFile(indexFilePath);
+    if(!indexFile.exists())
+    {
+        indexFile.setFileName(indexFilePath+".tmp");
+    }
+    if(!indexFile.open(QIODevice::ReadOnly))
+    {
+        return;//还没有索引文件
+    }
+    QDataStream in(&indexFile);
+    in.setVersion(QDataStream::Qt_4_6);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in>>magic>>version;
+    if(magic != USERDICTMAGIC || version != USERDICTVERSION)
+    {
+        qDebug()<<"UserDictionary:Invalid index file"<<indexFile.fileName();
+        return;
+    }
+    QHash<QString,QHash<QString,int> > weightTable;
+    QList<QPair<QString,QString> > phraseTable;
+    quint64 seq = 0;
+    in>>seq>>weightTable>>phraseTable;
+    if(in.status() != QDataStream::Ok)
+    {
+        qDebug()<<"UserDictionary:Corrupted index file"<<indexFile.fileName();
+        return;
+    }
+    wordWeight = weightTable;
+    for(int i=0;i<phraseTable.size();i++)
+    {
+        applyRecord('P',phraseTable.at(i).first,phraseTable.at(i).second,0);
+    }
+    sequence = seq;
+    indexSequence = seq;
+}
+/*
+ *@brief:   重放日志中索引之后的记录。每条记录带有校验和，掉电造成的不完整记录会被丢弃
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void UserDictionary::replayLog()
+{
+    QFile logFile(logFilePath);
+    if(!logFile.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+    while(!logFile.atEnd())
+    {
+        QByteArray line = logFile.readLine();
+        if(line.endsWith('\n'))
+        {
+            line.chop(1);
+        }
+        int checksumPos = line.lastIndexOf('\t');
+        if(checksumPos < 0)
+        {
+            continue;
+        }
+        QByteArray body = line.left(checksumPos);
+        bool ok = false;
+        quint16 checksum = line.mid(checksumPos+1).toUShort(&ok,16);
+        if(!ok || checksum != qChecksum(body.constData(),body.size()))
+        {
+            continue;//不完整或损坏的记录
+        }
+        QStringList fieldList = QString::fromUtf8(body).split("\t");
+        if(fieldList.size() != 5 || fieldList.at(1).length() != 1)
+        {
+            continue;
+        }
+        quint64 seq = fieldList.at(0).toULongLong();
+        if(seq <= indexSequence)
+        {
+            continue;//已包含在索引中
+        }
+        applyRecord(fieldList.at(1).at(0).toLatin1(),fieldList.at(2),fieldList.at(3),fieldList.at(4).toInt());
+        sequence = qMax(sequence,seq);
+        recordsSinceCompact++;
+    }
+}
+/*
+ *@brief:   将一条记录应用到内存中的词典
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ *@param:   type:记录类型 'W'为候选词权重 'P'为学习的词组
+ *@param:   key:拼音
+ *@param:   word:汉字
+ *@param:   value:权重增量
+ */
+void UserDictionary::applyRecord(char type, const QString &key, const QString &word, int value)
+{
+    if(type == 'W')
+    {
+        int &wordValue = wordWeight[key][word];
+        wordValue = qMin(wordValue+value,MAXWORDWEIGHT);
+    }
+    else if(type == 'P')
+    {
+        QString phraseId = key+"\t"+word;
+        if(phraseSet.contains(phraseId))
+        {
+            return;
+        }
+        phraseSet.insert(phraseId);
+        phraseList.append(qMakePair(key,word));
+        QStringList keyList = phraseKeys(key);
+        for(int i=0;i<keyList.size();i++)
+        {
+            phraseIndex.insert(keyList.at(i),word);
+        }
+    }
+}
+/*
+ *@brief:   编码一条记录并放入写缓存，由定时器批量交给写线程
+ * 记录格式: 序号\t类型\t拼音\t汉字\t数值\t校验和(16进制)
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+void UserDictionary::appendRecord(char type, const QString &key, const QString &word, int value)
+{
+    sequence++;
+    QByteArray body = QString("%1\t%2\t%3\t%4\t%5").arg(QString::number(sequence),QString(QChar(type)),
+                                                        key,word,QString::number(value)).toUtf8();
+    pendingRecords.append(body);
+    pendingRecords.append('\t');
+    pendingRecords.append(QByteArray::number(qChecksum(body.constData(),body.size()),16));
+    pendingRecords.append('\n');
+    recordsSinceCompact++;
+    if(!flushTimer.isActive())
+    {
+        flushTimer.start();
+    }
+}
+/*
+ *@brief:   序列化当前词典内容，作为压缩后的二进制索引
+ *@author:  缪庆瑞
+ *@date:    2026.10.19
+ */
+QByteArray UserDictionary::snapshot() const
+{
+    QByteArray data;
+    QDataStream out(&data,QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_6);
+    out<<quint32(USERDICTMAGIC)<<quint32(USERDICTVERSION)<<sequence<<wordWeight<<phraseList;
+    return data;
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+*
+* Copyright (C) 2016-2026 MiaoQingrui. All rights reserved.
+* Author: 缪庆瑞 <justdoit_mqr@163.com>
+*
+****************************************************************************/
+/*
+ *@author: 缪庆瑞
+ *@date:   2026.10.19
+ *@brief:  用户词典，记录用户选择的候选词权重及组词学习到的新词组。
+ * 持久化采用追加写日志+定期压缩为二进制索引的方式，日志写入在独立线程批量进行，
+ * 避免频繁写慢速flash阻塞界面。
+ */
+#ifndef USERDICTIONARY_H
+#define USERDICTIONARY_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMultiHash>
+#include <QSet>
+#include <QPair>
+#include <QList>
+#include <QThread>
+#include <QTimer>
+#include "dictionaryindex.h"
+
+/*用户词典写线程对象，负责日志追加和索引压缩，运行在独立线程中*/
+class UserDictionaryWriter : public QObject
+{
+    Q_OBJECT
+public:
+    UserDictionaryWriter(const QString &logPath,const QString &indexPath);
+
+public slots:
+    void appendRecords(const QByteArray &records);//追加日志记录
+    void compact(const QByteArray &snapshot);//写入压缩后的索引并清空日志
+
+private:
+    QString logFilePath;//追加写日志文件路径
+    QString indexFilePath;//二进制索引文件路径
+};
+
+class UserDictionary : public QObject, public DictionaryIndex
+{
+    Q_OBJECT
+public:
+    explicit UserDictionary(const QString &filePath,QObject *parent = 0);
+    ~UserDictionary();
+
+    void learnWord(const QString &pinyin,const QString &word);//提高拼音下候选词的权重
+    bool learnPhrase(const QString &phrase,const QString &word);//学习新词组
+    int weight(const QString &pinyin,const QString &word) const;//候选词的权重
+    QStringList phrases(const QString &pinyin) const;//拼音匹配的已学习词组
+    QList<QString> values(const QString &pinyin) const;//作为分层字典的一层，获取拼音匹配的词组
+    QList<QString> keys() const;//已学习词组的所有拼音
+    QList<QPair<QString,QString> > learnedPhrases() const;//所有已学习的词组 (拼音,汉字)
+    void sortByWeight(const QString &pinyin,QList<QString> &candidates) const;//按权重调整候选词顺序
+    void flush();//立即将缓存的记录交给写线程
+
+    static QStringList phraseKeys(const QString &phrase);//词组的全拼、简拼等匹配拼音
+
+signals:
+    void recordsReady(const QByteArray &records);
+    void compactRequested(const QByteArray &snapshot);
+
+private slots:
+    void flushSlot();
+
+private:
+    void loadIndex();//加载二进制索引
+    void replayLog();//重放索引之后的日志记录
+    void applyRecord(char type,const QString &key,const QString &word,int value);
+    void appendRecord(char type,const QString &key,const QString &word,int value);
+    QByteArray snapshot() const;//序列化当前词典内容
+
+    QString logFilePath;
+    QString indexFilePath;
+    //内存中的词典内容
+    QHash<QString,QHash<QString,int> > wordWeight;//拼音-(候选词-权重)
+    QList<QPair<QString,QString> > phraseList;//学习的词组 (拼音,汉字)
+    QSet<QString> phraseSet;//词组去重
+    QMultiHash<QString,QString> phraseIndex;//词组全拼、简拼-汉字
+    //持久化相关
+    quint64 sequence;//最新记录的序号
+    quint64 indexSequence;//二进制索引包含的最后一条记录序号
+    QByteArray pendingRecords;//待写入的记录
+    int recordsSinceCompact;//上次压缩后产生的记录数
+    QTimer flushTimer;//批量写入定时器
+    QThread writerThread;
+    UserDictionaryWriter *writer;
+};
+
+#endif // USERDICTIONARY_H